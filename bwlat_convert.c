@@ -0,0 +1,180 @@
+/*
+ * MPI LATENCY FLOW TESTS - CONVERSION DU FICHIER BINAIRE DES RESULTATS
+ *
+ * Lit par mmap un fichier binaire ecrit avec l'option -B de bwlat, et l'exporte sur la sortie standard en YAML (meme structure
+ * que l'option -o), CSV (une ligne par lien) ou JSON.
+ *
+ * Copyright (C) 2010 Julien VAUBOURG / Sébastien BADIA
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <unistd.h>
+
+#include "results_file.h"
+
+void toYAML(ResultsFile* f);
+void toCSV(ResultsFile* f);
+void toJSON(ResultsFile* f);
+void usage(void);
+
+int main(int argc, char** argv) {
+	ResultsFile f;
+	char format[8] = "yaml";
+	int opt;
+
+	while((opt = getopt(argc, argv, "hf:")) != -1) {
+		switch(opt) {
+			case 'f' :
+				strncpy(format, optarg, 7);
+			break;
+
+			default :
+				usage();
+				exit(opt == 'h' ? 0 : 1);
+		}
+	}
+
+	if(optind != argc - 1) {
+		usage();
+		exit(1);
+	}
+
+	if(strcmp(format, "yaml") != 0 && strcmp(format, "csv") != 0 && strcmp(format, "json") != 0) {
+		fprintf(stderr, "ERROR: The -f option must be yaml, csv or json.\n");
+		exit(1);
+	}
+
+	if(!resultsFileMap(argv[optind], &f))
+		exit(1);
+
+	if(strcmp(format, "csv") == 0)
+		toCSV(&f);
+	else if(strcmp(format, "json") == 0)
+		toJSON(&f);
+	else
+		toYAML(&f);
+
+	resultsFileUnmap(&f);
+
+	return 0;
+}
+
+/*
+ * Export YAML : envoyeur => receveur => champs mesures (ceux restes a -1 ne sont pas ecrits). Les liens d'un meme envoyeur sont
+ * regroupes sous son nom tant qu'ils se suivent dans le fichier, ce qui est le cas de la matrice classique.
+ */
+void toYAML(ResultsFile* f) {
+	Bench b;
+	size_t field;
+	int i, last = -1;
+
+	printf("---\n");
+
+	for(i = 0; i < f->nbRecords; i++) {
+		resultsFileGet(f, i, &b);
+
+		if(b.sender != last)
+			printf("%s :\n", resultsFileHostname(f, b.sender));
+
+		last = b.sender;
+		printf("  %s :\n", resultsFileHostname(f, b.recver));
+
+		for(field = offsetof(Bench, latency); field < sizeof(Bench); field += sizeof(float)) {
+			if(BENCH_FIELD(&b, field) != -1)
+				printf("    %s : %.3f\n", benchFieldNames[BENCH_INDEX(field)], BENCH_FIELD(&b, field));
+		}
+	}
+}
+
+/*
+ * Export CSV : une ligne par lien, avec les ranks et les noms des deux noeuds puis tous les champs (-1 si non mesure).
+ */
+void toCSV(ResultsFile* f) {
+	Bench b;
+	size_t field;
+	int i;
+
+	printf("sender,recver,sender_host,recver_host");
+
+	for(field = offsetof(Bench, latency); field < sizeof(Bench); field += sizeof(float))
+		printf(",%s", benchFieldNames[BENCH_INDEX(field)]);
+
+	printf("\n");
+
+	for(i = 0; i < f->nbRecords; i++) {
+		resultsFileGet(f, i, &b);
+		printf("%d,%d,%s,%s", b.sender, b.recver, resultsFileHostname(f, b.sender), resultsFileHostname(f, b.recver));
+
+		for(field = offsetof(Bench, latency); field < sizeof(Bench); field += sizeof(float))
+			printf(",%.3f", BENCH_FIELD(&b, field));
+
+		printf("\n");
+	}
+}
+
+/*
+ * Export JSON : l'entete (parametres du test), la table des hostnames, puis la liste des liens avec leurs champs mesures.
+ */
+void toJSON(ResultsFile* f) {
+	ResultsFileHeader* h = f->header;
+	Bench b;
+	size_t field;
+	int i;
+
+	printf("{\n  \"version\": %d,\n  \"nbNodes\": %d,\n  \"flags\": %d,\n  \"pktSize\": %d,\n  \"nbRetry\": %d,\n",
+		h->version, h->nbNodes, h->flags, h->pktSize, h->nbRetry);
+	printf("  \"window\": %d,\n  \"nbWindows\": %d,\n  \"seed\": %u,\n", h->window, h->nbWindows, h->seed);
+
+	/* Politique des buffers et synchronisation RMA, inconnues avant la version 2 (l'ancien champ reserve, a zero, vaut sans RMA) */
+	if(h->version >= 2)
+		printf("  \"bufferPolicy\": %d,\n  \"coldSize\": %d,\n  \"rmaSync\": %d,\n", h->bufferPolicy, h->coldSize, h->rmaSync);
+
+	printf("  \"hostnames\": [");
+
+	for(i = 0; i < h->nbNodes; i++)
+		printf("%s\"%s\"", i ? ", " : "", resultsFileHostname(f, i));
+
+	printf("],\n  \"links\": [");
+
+	for(i = 0; i < f->nbRecords; i++) {
+		resultsFileGet(f, i, &b);
+		printf("%s\n    {\"sender\": %d, \"recver\": %d", i ? "," : "", b.sender, b.recver);
+
+		for(field = offsetof(Bench, latency); field < sizeof(Bench); field += sizeof(float)) {
+			if(BENCH_FIELD(&b, field) != -1)
+				printf(", \"%s\": %.3f", benchFieldNames[BENCH_INDEX(field)], BENCH_FIELD(&b, field));
+		}
+
+		printf("}");
+	}
+
+	printf("\n  ]\n}\n");
+}
+
+void usage(void) {
+	puts("BWLAT RESULTS CONVERTER");
+	puts("------------------------");
+	puts("\tbwlat_convert [-f yaml|csv|json] <file>");
+	puts("");
+	puts("\t-f <fmt>  : Output format on the standard output: yaml (default), csv or json.");
+	puts("\t<file>    : Binary results file written by bwlat -B.");
+	puts("");
+	puts("\t-h        : This help.");
+}
@@ -33,6 +33,15 @@
 #include <time.h>
 #include <unistd.h>
 #include <math.h>
+#include <stddef.h>
+#include <float.h>
+#include <sys/mman.h>
+#include <pthread.h>
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#include <x86intrin.h>
+#include <cpuid.h>
+#endif
 #include <mpi.h>
 
 #include "latency_flow_tests.h"
@@ -42,64 +51,224 @@ int main(int argc, char** argv) {
 	int
 		rank, /* Numero du noeud qui execute le script, par rapport au nb de noeuds concernes par l'execution */
 		nbNodes, /* Nombre de noeuds concernes par l'execution du programme */
-		pktSize, /* Taille du mot qui sera envoye pour faire les tests de debit */
-		nbRetry, /* Nb de fois qu'un test sera recommence afin d'augmenter la precision */
-		bissection, /* Mode bissection ? */
-		randBiss, /* Mode bissection, avec formation des paires aleatoires ? */
-		yaml, /* Sortie dans un fichier YAML (yamlFile) en plus de la matrice ? */
-		gnuplot, /* Sortie pour un graphique gnuplot plutot qu'une matrice ? */
-		i, sender, recver, l; /* Divers compteurs */
+		maxSamples, /* Nombre maximum de repetitions conservees d'un meme test (nbRetry, ou plus en mode adaptatif) */
+		n, /* Nombre de repetitions conservees du test courant, echauffement exclu */
+		nbMyResults, /* Nombre de resultats gardes par le noeud jusqu'a la fin des tests, en mode distribue */
+		nbRegressions = 0, /* Nombre de liens moins bons que dans les resultats de reference (option -R) */
+		placed = 1, /* Placement des ranks reussi, ou non demande (option -G) */
+		nbTimeouts = 0, /* Nombre de liens dont le test a depasse son delai (option -e) */
+		nbLost = 0, /* Nombre de resultats que le MASTER a cesse d'attendre, d'envoyeurs peut-etre bloques (option -e) */
+		timedOut, /* Le test courant a depasse son delai (option -e) */
+		done, /* Nombre de repetitions achevees du test courant, echauffement compris */
+		threadLevel = MPI_THREAD_SINGLE, /* Niveau de support des threads fourni par la bibliotheque MPI */
+		i, sender, recver, round, l, k; /* Divers compteurs */
 	float
-		sumLatency, /* Somme de toutes les latences d'un meme test afin de pouvoir faire la moyenne */
-		sumFlow; /* Idem pour le debit */
+		*sameSweeps, /* Courbes latence/debit de chaque repetition d'un meme test, si le balayage des tailles (-S) est actif */
+		*mySweeps = NULL, /* Courbes gardees par le noeud jusqu'a la fin des tests, en mode distribue */
+		*mySweep, /* Courbe moyenne que fabriquera le noeud a partir de son test (latences puis debits, pour chaque taille) */
+		*bissSweeps, /* Courbes de tous les envoyeurs d'une bissection ou d'un tour, dont l'indice indique le rank de l'envoyeur */
+		*sweepResults = NULL; /* Courbes de toutes les paires testees, rangees comme une matrice (voir sweepOf). Ne sert que pour le rank 0 */
 	YourTest
 		*bissTests, /* Tableau de tous les tests a envoyer, sert pour le rank 0 */
 		myTest; /* Test que recevra le noeud si il n'est pas le rank 0 */
 	Bench
-		*sameBenchs; /* Tableau qui recevra tous les resultats des benchs d'un meme test, a partir desquels on fera des moyennes */
-	MyResult
+		*sameBenchs, /* Tableau qui recevra tous les resultats des benchs d'un meme test, a partir desquels on fera des moyennes */
 		myResult, /* Resultat que fabriquera le noeud a partir de son test, si il n'est pas le rank 0 */
-		*bissResults, /* Tableau final contenant tous les resultats des tests, dont l'indice indique le rank du sender du test */
-		**benchResults; /* Idem mais a deux dimensions : en y le sender, en x le receveur. Ne sert aussi que pour le rank 0 */
+		*myResults = NULL, /* Resultats gardes par le noeud jusqu'a la fin des tests, en mode distribue */
+		*bissResults; /* Resultats de tous les envoyeurs d'une bissection ou d'un tour, dont l'indice indique le rank de l'envoyeur */
+	Results
+		results; /* Resultats de toutes les paires, en matrices de flottants : en y le sender, en x le receveur. Ne sert que pour le rank 0 */
+	ResultsFile
+		baseline; /* Resultats de reference projetes en memoire (option -R), pour le rank 0 */
+	Histo
+		latencyHisto, flowHisto, /* Distributions des repetitions du test courant, pour l'envoyeur */
+		myLatencyHisto, myFlowHisto; /* Distributions des repetitions de tous les tests du noeud, reunies a la fin sur le MASTER */
+	char
+		*hostnames, /* Table des hostnames de tous les ranks (voir createHostnames) */
+		timerInfo[128]; /* Description de l'horloge des mesures (option -k) */
+	Topology
+		topo; /* Machine de chaque rank, et ranks testes selon l'option -t */
 	StatsResult
 		latencyStats, /* Pointeurs vers les benchs ayant enregistres les latences min et max, ainsi que la somme de toutes les latences et la moyenne */
-		flowStats; /* Idem pour les debits */
-	char
-		yamlFile[50]; /* Nom du fichier qui accueillera la sortie YAML si l'option -o est passee */
+		flowStats, /* Idem pour les debits */
+		streamStats, /* Idem pour les debits en flux continu */
+		bidirStats[3], /* Idem pour les debits bidirectionnels : agrege, envoyeur vers receveur et receveur vers envoyeur */
+		integrityStats[2], /* Idem pour les debits verifies et les nombres de mots corrompus */
+		rmaStats[4], /* Idem pour les latences et les debits RMA de Put puis de Get */
+		oneWayStats[2], /* Idem pour les latences de l'envoyeur vers le receveur, puis du receveur vers l'envoyeur */
+		classStats[4]; /* Idem pour les latences et les debits des liens internes aux machines, puis entre machines */
+	SweepStats
+		sweepStats; /* Min, moyenne et max des latences et des debits pour chaque taille du balayage */
+	Clocks
+		clocks; /* Decalages et derives des horloges de tous les ranks par rapport au MASTER (option -O), pour le rank 0 */
+	Options
+		opts; /* Options passees au script (voir -h) */
 
 
 	/* Initialisation des connexions MPI et recuperation du nb de noeuds concernes par l'execution
-	ainsi que le numero - rang - du noeud courant courant */
-	MPI_Init(&argc, &argv);
+	ainsi que le numero - rang - du noeud courant courant. Seul le test multi threads (option -n) demande MPI_THREAD_MULTIPLE, qui
+	peut ralentir les communications de certaines bibliotheques MPI */
+	if(threadsRequested(argc, argv))
+		MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &threadLevel);
+	else
+		MPI_Init(&argc, &argv);
+
     	MPI_Comm_size(MPI_COMM_WORLD, &nbNodes);
     	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
 
 	/* Prise en compte des differentes options passées au script */
-	initOptions(argc, argv, nbNodes, rank, &pktSize, &nbRetry, &bissection, &randBiss, &gnuplot, &yaml, yamlFile);
+	initOptions(argc, argv, nbNodes, rank, &opts);
+
+	if(opts.threads > 0 && threadLevel < MPI_THREAD_MULTIPLE) {
+		if(rank == MASTER)
+			fprintf(stderr, "ERROR: The -n option requires a MPI library with MPI_THREAD_MULTIPLE support.");
+
+		exit(1);
+	}
+
+	/* En mode distribue (ou echantillonne), tous les noeuds calculent le meme ordonnancement (ou les memes partenaires) a partir
+	de la graine du MASTER */
+	if(opts.distributed || opts.sampled)
+		MPI_Bcast(&opts.seed, 1, MPI_UNSIGNED, MASTER, MPI_COMM_WORLD);
 
-	/*  Le buffer sert pour envoyer ou recevoir le mot qui sert de test au debit */
-	buffer = (int *) malloc(sizeof(int)*pktSize);
+	/*  Le buffer sert pour envoyer ou recevoir le mot qui sert de test au debit, ainsi que les mots du balayage des tailles. Il
+	est pris dans une reserve allouee selon la politique de l'option -P */
+	bufferAlloc(&opts);
 	l = 0;
 
-	if(buffer == NULL) {
+	/* Delai des tests (option -e) : nombre de tests deja faits avec chaque rank, dont les etiquettes des messages sont tirees */
+	if(opts.timeout > 0) {
+		pairTests = (int*) calloc(nbNodes, sizeof(int));
+
+		if(pairTests == NULL) {
+			fprintf(stderr, "ERROR: Can't allocate memory.");
+			exit(1);
+		}
+	}
+
+	/* En mode adaptatif (option -a), un test peut etre repete jusqu'a maxRetry fois */
+	maxSamples = (opts.target > 0 && opts.maxRetry > opts.nbRetry) ? opts.maxRetry : opts.nbRetry;
+
+	/* Les courbes sont echangees comme de simples tableaux de 2*nbSizes flottants (au moins un pour rester allouable) */
+	k = 2 * opts.nbSizes + 1;
+	mySweep = (float*) malloc(sizeof(float) * k);
+	sameSweeps = (float*) malloc(sizeof(float) * k * maxSamples);
+	bissSweeps = (float*) malloc(sizeof(float) * k * nbNodes);
+
+	if(buffer == NULL || mySweep == NULL || sameSweeps == NULL || bissSweeps == NULL) {
 		fprintf(stderr, "ERROR: Can't allocate memory.");
 		exit(1);
 	}
 
+	/* Etalonnage de l'horloge des mesures (option -k) sur chaque noeud */
+	timerInit(rank, &opts);
+
 	/* Creation des structures qui pourront dorenavant transiter d'un noeud a l'autre avec MPI */
 	createBenchType();
 	createTestType();
-	createResultType();
+	crc32cInit();
+
+	/* Les hostnames ne sont echanges qu'une fois, et ne transitent plus avec chaque resultat */
+	hostnames = createHostnames(nbNodes);
+
+	/* Regroupement des ranks par machine (memoire partagee), connu de tous les noeuds */
+	createTopology(&topo, nbNodes, &opts);
+
+	/* Mode echantillonne (option -K) : les memes decalages des partenaires sur tous les noeuds */
+	if(opts.sampled)
+		sampleInit(&topo, &opts);
+
+	histoInit(&myLatencyHisto);
+	histoInit(&myFlowHisto);
+
+	/* Latence dans chaque sens (option -O) et collectives (option -C) : les horloges de tous les ranks sont comparees a celle du
+	MASTER avant les tests */
+	if(opts.oneWay || opts.collectives)
+		clockStart(rank, nbNodes, &clocks);
+
+	/* Mode incast/outcast (option -f) : les roles sont fixes (le rank 1 face a K autres noeuds), chacun les deduit de K sans
+	attendre de test du MASTER, qui ne fait que donner les departs et recueillir les resultats */
+	if(opts.fan > 0) {
+		fanAllTests(rank, nbNodes, hostnames, &opts);
+		MPI_Finalize();
+
+		return 0;
+	}
+
+	/* Mode surveillance (option -m) : un tour de la matrice est teste toutes les T secondes, jusqu'a l'arret du programme */
+	if(opts.monitor > 0) {
+		monitorAllTests(rank, nbNodes, hostnames, &topo, &opts);
+		MPI_Finalize();
+
+		return 0;
+	}
+
+	/* Mode multi threads (option -n) : les paires de la bissection sont fixes, chaque noeud deduit son role de son rank */
+	if(opts.threads > 0) {
+		threadsAllTests(rank, nbNodes, hostnames, &opts);
+		MPI_Finalize();
+
+		return 0;
+	}
+
+	/* Mode latence sous charge (option -L) : les roles sont fixes, chaque noeud deduit le sien de son rank */
+	if(opts.loaded > 0) {
+		loadedAllTests(rank, nbNodes, hostnames, &opts);
+		MPI_Finalize();
+
+		return 0;
+	}
+
+	/* Mode collectives (option -C) : tous les noeuds testes participent a chaque operation, le MASTER ne fait que recueillir les
+	durees a la fin */
+	if(opts.collectives) {
+		collAllTests(rank, nbNodes, hostnames, &clocks, &opts);
+		MPI_Finalize();
+
+		return 0;
+	}
+
+	/* En mode distribue, chaque noeud teste garde ses resultats d'envoyeur (au plus un par tour) jusqu'a la fin */
+	if(opts.distributed && rank != MASTER) {
+		bissTests = (YourTest*) malloc(sizeof(YourTest)*nbNodes);
+		myResults = (Bench*) malloc(sizeof(Bench)*rrNbRounds(topo.nbPlayers));
+		mySweeps = (float*) malloc(sizeof(float) * (2 * opts.nbSizes * rrNbRounds(topo.nbPlayers) + 1));
+		nbMyResults = 0;
+
+		if(bissTests == NULL || myResults == NULL || mySweeps == NULL) {
+			fprintf(stderr, "ERROR: Can't allocate memory.");
+			exit(1);
+		}
+	}
 
 	/* Le MASTER est le rank 0, c'est lui qui enverra les tests, qui recevra les resultats et qui les affichera.
 	Il ne fait pas parti des tests. */
 	if(rank == MASTER) {
 
+		/* Matrice des courbes du balayage, initialisee a -1 pour reperer les paires non testees */
+		if(opts.nbSizes > 0) {
+			sweepResults = (float*) malloc(sizeof(float) * 2 * opts.nbSizes * nbNodes * nbNodes);
+
+			if(sweepResults == NULL) {
+				fprintf(stderr, "ERROR: Can't allocate memory.");
+				exit(1);
+			}
+
+			for(i = 0; i < 2 * opts.nbSizes * nbNodes * nbNodes; sweepResults[i++] = -1);
+		}
+
+		/* Matrices des resultats, initialisees a -1 pour reperer les paires non testees */
+		initResults(&results, nbNodes, hostnames, &topo, &opts);
+
+		/* Le fichier de reference est lu avant les tests, pour ne pas les faire pour rien */
+		if(opts.compare && !resultsFileMap(opts.baselineFile, &baseline))
+			exit(1);
+
 		/* Le mode bissection (option -b) consiste a creer des paires de noeuds dans ceux faisant parti de l'execution du programme
 		et faire envoyer un mot d'un noeud a l'autre, en demarrant tous en meme tps */
-		if(bissection) {
+		if(opts.bissection) {
 			bissTests = (YourTest*) malloc(sizeof(YourTest)*nbNodes);
-			bissResults = (MyResult*) malloc(sizeof(MyResult)*nbNodes);
+			bissResults = (Bench*) malloc(sizeof(Bench)*nbNodes);
 
 			if(bissTests == NULL || bissResults == NULL) {
 				fprintf(stderr, "ERROR: Can't allocate memory.");
@@ -107,13 +276,16 @@ int main(int argc, char** argv) {
 			}
 
 			/* Si l'option -rb est active, alors les formations de paires se feront aleatoirement parmis les noeuds dispo */
-			if(randBiss)
-				bissPrepareAllRandTests(bissTests, nbNodes);
+			if(opts.randBiss)
+				bissPrepareAllRandTests(bissTests, topo.nbPlayers);
 
 			/* Sinon, elles se font en coupant le nombre de noeuds en deux et en prenant le premier de la premiere moitie et le
 			premier de la seconde, et ainsi de suite */
 			else
-				bissPrepareAllTests(bissTests, nbNodes);
+				bissPrepareAllTests(bissTests, topo.nbPlayers);
+
+			/* Les paires sont formees entre les ranks testes (option -t), puis filtrees selon la classe de liens choisie */
+			topoMapTests(bissTests, &topo, &opts);
 
 			/* Transmission des tests prepares aux interesses : c'est une fonction collective, ce qui signifie que tous les noeuds
 			doivent avoir execute cette meme fonction, et etre en attente de cet appel du rank 0 (sinon, ils seront attendus).
@@ -124,139 +296,218 @@ int main(int argc, char** argv) {
 			/* Chaque noeud est en ecoute de cette meme fonction (puisque c'est aussi une fonction collective). Elle envoi un mot vide
 			en broadcast a tous pour leur dire que le jeu debute : les receveurs se mettent a ecouter les envoyeurs, et les envoyeurs
 			envoient aux receveurs. Chacun se remet ensuite en ecoute du rank 0, et ce jusqu'a ce que la precision imposee par nbRetry
-			soit atteinte. */
-			for(i = 0; i < nbRetry; i++)
+			soit atteinte (ou, en mode adaptatif, jusqu'a ce que tous les envoyeurs aient converge). */
+			for(i = 0; nextTest(&myTest, i, 0, &opts); i++)
 				bissLaunchAllTests();
 
 			/* Derniere fonction collective : tout le monde envoi son resultat, seuls les resultats des envoyeurs auront de l'interet */
 			bissTransmitAllResults(bissResults, &myResult);
+			storeAllResults(&results, bissResults);
+
+			if(opts.nbSizes > 0) {
+				bissTransmitAllSweeps(bissSweeps, mySweep, &opts);
+				bissStoreAllSweeps(sweepResults, bissSweeps, bissResults, nbNodes, &opts);
+			}
 
 		/* Le contraire du mode bissection est le mode matrice : chaque noeud enverra un noeud a tous les autres, afin de pouvoir creer
 		une matrice complete des performances entre tous les noeuds concerne par l'execution, dans tous les sens */
 		} else {
 
-			benchResults = (MyResult**) malloc(sizeof(MyResult*)*nbNodes);
-
-			if(benchResults == NULL) {
-				fprintf(stderr, "ERROR: Can't allocate memory.");
-				exit(1);
-			}
-
-			for(i = 0; i < nbNodes; i++) {
-				benchResults[i] = (MyResult*) malloc(sizeof(MyResult)*nbNodes);
+			/* Mode matrice concurrent (option -c) : les paires envoyeur/receveur sont organisees en tournoi round-robin (methode
+			du cercle). A chaque tour, tous les noeuds sont engages dans une paire disjointe des autres, et les tests du tour sont
+			distribues, lances et recuperes avec les memes fonctions collectives que la bissection. Chaque paire ordonnee est
+			couverte une fois en 2(N-1) tours environ, au lieu des N(N-1) tests en serie du mode matrice classique. */
+			if(opts.concurrent) {
+				bissTests = (YourTest*) malloc(sizeof(YourTest)*nbNodes);
+				bissResults = (Bench*) malloc(sizeof(Bench)*nbNodes);
 
-				if(benchResults[i] == NULL) {
+				if(bissTests == NULL || bissResults == NULL) {
 					fprintf(stderr, "ERROR: Can't allocate memory.");
 					exit(1);
 				}
-			}
 
-			for(sender = 1; sender < nbNodes; sender++) {
+				for(round = 0; round < topoNbRounds(&topo, &opts); round++) {
 
-				/* Preparation des tests pour le noeud envoyeur : mise en ecoute de ce noeud, pour tous les autres
-				noeuds qui recevront tour a tour un mot de lui. Chacun de ces noeuds recoit donc un test de receveur */
-				prepareTests(nbNodes, sender);
+					/* En mode distribue (option -l), chaque noeud calcule lui meme son test du tour et garde ses resultats :
+					le MASTER ne fait que donner les departs */
+					if(!opts.distributed) {
+						if(opts.sampled)
+							samplePrepareRoundTests(bissTests, topo.nbPlayers, round, &opts);
+						else
+							rrPrepareRoundTests(bissTests, topo.nbPlayers, round);
 
-				for(recver = 1; recver < nbNodes; recver++) {
-					if(recver != sender) {
+						topoMapTests(bissTests, &topo, &opts);
+						bissTransmitAllTests(bissTests, &myTest);
+					}
 
-						/* Envoi d'un test a l'envoyeur, lui indiquant de communiquer avec le receveur courant */
-						launchTests(sender, recver);
+					/* Depart synchro de chaque repetition du tour, comme pour la bissection */
+					for(i = 0; nextTest(&myTest, i, 0, &opts); i++)
+						bissLaunchAllTests();
+
+					if(opts.distributed)
+						continue;
+
+					bissTransmitAllResults(bissResults, &myResult);
 
-						/* Reception du resultat du test, directement dans la matrice des resultats */
-						receiveResults(&benchResults[sender][recver], sender);
+					if(opts.nbSizes > 0) {
+						bissTransmitAllSweeps(bissSweeps, mySweep, &opts);
+						bissStoreAllSweeps(sweepResults, bissSweeps, bissResults, nbNodes, &opts);
 					}
+
+					/* Seuls les resultats des envoyeurs du tour sont ranges dans la matrice */
+					storeAllResults(&results, bissResults);
 				}
-			}
-		}
 
-		/* Calcul des statistiques */
-		stats(benchResults, bissResults, &latencyStats, &flowStats, nbNodes, bissection);
+				/* Mode distribue : tous les resultats arrivent en une seule fois, a la fin */
+				if(opts.distributed)
+					distTransmitAllResults(NULL, NULL, 0, &results, sweepResults, &opts);
 
-		/* Ecriture d'un fichier YAML si l'option -o est passee */
-		if(yaml)
-			toYAML(benchResults, bissResults, yamlFile, nbNodes, bissection);
+			/* Sinon, un seul test a la fois : les resultats ne subissent aucune contention (reference) */
+			} else for(i = 1; i < topo.nbPlayers; i++) {
+				sender = topo.players[i];
 
-		/* Sortie en coordonnees pour un graphique gnuplot des debits selon des bissections */
-		if(gnuplot) {
-			toGnuplot(&flowStats, nbNodes);
+				/* Preparation des tests pour le noeud envoyeur : mise en ecoute de ce noeud, pour tous les autres
+				noeuds (ou ses seuls partenaires en mode echantillonne) qui recevront tour a tour un mot de lui. Chacun de ces
+				noeuds recoit donc un test de receveur. Avec un delai (option -e), chaque receveur n'est prevenu qu'au lancement de
+				son test, pour que sa date limite soit celle de l'envoyeur */
+				if(opts.timeout <= 0)
+					prepareTests(&topo, i, &opts);
 
-		/* Sinon matrice + stats */
-		} else {
+				for(k = 0; k < topoNbRecvers(&topo, &opts); k++) {
+					recver = topoRecver(&topo, i, k, &opts);
 
-			/* Affichage d'un tableau/matrice non-parsable sur la sortie standard */
-			displayTab(benchResults, bissResults, bissection, nbNodes);
+					/* Seuls les liens de la classe choisie (option -t) sont testes */
+					if(linkSelected(&topo, sender, recver, &opts)) {
+						if(opts.timeout > 0)
+							prepareTest(sender, recver);
 
-			/* Affichage des statistiques sur la sortie standard */
-			displayStats(benchResults, bissResults, &latencyStats, &flowStats, nbNodes, bissection);
+						/* Envoi d'un test a l'envoyeur, lui indiquant de communiquer avec le receveur courant */
+						launchTests(sender, recver);
+
+						/* Reception du resultat du test, attendu au plus le delai du test et une marge pour son envoi, puis
+						rangement dans les matrices des resultats. Un envoyeur muet laisse le lien hors delai, sans courbe */
+						if(receiveResults(&myResult, sender, recver, opts.timeout > 0 ? MPI_Wtime() + opts.timeout + TIMEOUT_GRACE : 0, &opts)) {
+
+							/* Suivi de la courbe du balayage, si il est actif */
+							if(opts.nbSizes > 0)
+								receiveSweep(sweepOf(sweepResults, sender, recver, nbNodes, &opts), sender, &opts);
+						} else
+							nbLost++;
+
+						storeResult(&results, &myResult);
+					}
+				}
+			}
 		}
 
 	/* Si le noeud qui execute le programme n'est pas le MASTER (rank != 0), alors il sera charge de participer aux tests
 	qui lui enverra le MASTER, et de lui en renvoyer les resultats.
 	Dans le cas d'une bissection, chaque noeud n'aura qu'un seul role dans sa vie (envoyeur ou receveur), alors que dans le
 	cas de matrice, chacun des noeuds autant de fois envoyeur qu'il y a de noeud, et autant de fois receveur. A l'exclusion,
-	chaque fois, du rank 0, d'ou le -2 */
-	} else while(l++ < (bissection ? 1 : nbNodes*2-4)) {
+	chaque fois, du rank 0 et des liens ecartes par l'option -t (voir topoNbTests). En mode matrice concurrent, chacun recoit un
+	test (eventuellement desactive) a chaque tour. */
+	} else while(l++ < topoNbTests(&topo, rank, &opts)) {
 
-		sameBenchs = (Bench *) malloc(sizeof(Bench)*nbRetry);
+		sameBenchs = (Bench *) malloc(sizeof(Bench)*maxSamples);
 
 		if(sameBenchs == NULL) {
 			fprintf(stderr, "ERROR: Can't allocate memory.");
 			exit(1);
 		}
 
-		/* Si c'est une bissection, la fonction collective est utilise pour recevoir le test en meme tps que tout le monde */
-		if(bissection)
+		/* En mode distribue, le test du tour est calcule localement, sans rien demander au MASTER */
+		if(opts.distributed) {
+			distPrepareRoundTests(bissTests, topo.nbPlayers, l-1, opts.seed);
+			topoMapTests(bissTests, &topo, &opts);
+			myTest = bissTests[rank];
+
+		/* Si c'est une bissection (ou un tour de la matrice concurrente), la fonction collective est utilise pour recevoir le test
+		en meme tps que tout le monde */
+		} else if(opts.bissection || opts.concurrent)
 			bissTransmitAllTests(bissTests, &myTest);
 
 		/* Sinon, le noeud est simplement en ecoute d'un test sur le rank 0 */
 		else
 			waitTests(&myTest);
 
-		/* Formatage du type MyResult qui sera renvoye, en renseignant le hostname du noeud courant, les deux joueurs de ce tests
-		et les valeurs du flow et debit initialisees a -1 */
+		/* Formatage du Bench qui sera renvoye, en renseignant les deux joueurs de ce tests et les valeurs du flow et debit
+		initialisees a -1 */
 		formatTestsResult(&myResult, &myTest, rank);
 
+		/* Date limite du test, si il a un delai (option -e) */
+		testStart(&myTest, &opts);
+		timedOut = 0;
+
 		switch(myTest.role) {
 
 			/* Le test recu du rank 0 designe le noeud temporairement comme envoyeur */
 			case SENDER :
 
 				/* Les tests avec le noeud receveur se repeteront autant de fois que l'indication de precision
-				nbRetry l'impose */
-				for(i = 0; i < nbRetry; i++) {
+				nbRetry l'impose, apres les repetitions d'echauffement (option -u) dont les resultats sont ecrases.
+				En mode adaptatif, ils continuent ensuite tant que la mediane n'est pas assez precise, et s'arretent des que le
+				test a depasse son delai (option -e). */
+				for(i = 0, done = 0; nextTest(&myTest, i, !timedOut && moreTests(sameBenchs, i, &opts), &opts); i++) {
+					n = (i < opts.warmup) ? 0 : i - opts.warmup;
 
 					/* Si c'est une bissection, la fonction collective de lancement des tests est rappellee a chaque fois.
 					Ceci permet d'etre assure que tout le monde recommence bien son test au meme moment. Sans cela, les couples
 					qui auraient pris du retard sur le premier test se retrouveront seuls dans les derniers tests, lorsque les
 					plus rapides les auront tous finis. Il seront donc moins ralentis pour ces derniers tests, qui fausseront
 					leur moyenne. */
-					if(bissection)
+					if(opts.bissection || opts.concurrent)
 						bissLaunchAllTests();
 
+					/* Apres un depassement du delai, les repetitions restantes ne sont plus que des departs synchro */
+					if(timedOut)
+						continue;
+
 					/* Envoi du mot vide pour la latence, reception du resultat, envoi du mot de pktSize octets pour le debit,
 					reception du resultat.
 					Les differences de temps entre chaque envoi et reponse permettent de calculer la latence et le debit, qui
 					seront stockes dans le tableau des benchs de ce test, passe en parametre en ecriture. */
-					benchTests(&myTest, &sameBenchs[i], pktSize);
+					if(benchTests(&myTest, &sameBenchs[n], &sameSweeps[n * 2 * opts.nbSizes], &opts))
+						done = i + 1;
+					else
+						timedOut = 1;
 				}
 
-				sumLatency = sumFlow = 0;
-
-				/* Calcul des sommes pour etablir une moyenne de tous les resultats du meme test */
-				for(i = 0; i < nbRetry; i++) {
-					sumLatency += sameBenchs[i].latency;
-					sumFlow += sameBenchs[i].flow;
+				/* Nombre de repetitions conservees, les seules achevees avant le delai */
+				n = (done < opts.warmup) ? 0 : done - opts.warmup;
+
+				/* Moyennes, medianes et resume des distributions de toutes les repetitions du meme test, dans le Bench qui
+				sera renvoye au MASTER. Un test hors delai sans aucune repetition achevee garde ses champs a -1 */
+				if(n > 0)
+					benchsSummary(sameBenchs, n, &myResult, &latencyHisto, &flowHisto);
+				else {
+					histoInit(&latencyHisto);
+					histoInit(&flowHisto);
+					myResult.samples = 0;
 				}
 
-				/* Calcul des moyennes et initialisation des valeurs du MyResult qui sera renvoye au MASTER */
-				myResult.result.latency = sumLatency / nbRetry;
-				myResult.result.flow = sumFlow / nbRetry;
+				if(opts.timeout > 0)
+					myResult.timedOut = timedOut;
 
-				/* Si ca n'est pas une bissection, renvoi direct des resultats au MASTER */
-				if(!bissection)
+				/* Les histogrammes complets s'ajoutent a ceux de tous les tests du noeud, reunis a la fin sur le MASTER */
+				histoMerge(&myLatencyHisto, &latencyHisto);
+				histoMerge(&myFlowHisto, &flowHisto);
+
+				/* Idem pour chaque point de la courbe du balayage */
+				for(k = 0; k < 2 * opts.nbSizes; k++) {
+					for(mySweep[k] = 0, i = 0; i < n; i++)
+						mySweep[k] += sameSweeps[i * 2 * opts.nbSizes + k];
+
+					mySweep[k] = (n > 0) ? mySweep[k] / n : -1;
+				}
+
+				/* Si ca n'est pas une bissection ni un tour concurrent, renvoi direct des resultats au MASTER */
+				if(!opts.bissection && !opts.concurrent) {
 					sendResults(&myResult);
 
+					if(opts.nbSizes > 0)
+						sendSweep(mySweep, &opts);
+				}
+
 			break;
 
 			/* Le role du desactive intervient dans un unique cas de figure : en mode bissection, si le nombre de noeud, en l'enlevant le rank 0,
@@ -267,31 +518,211 @@ int main(int argc, char** argv) {
 			/* Cas d'un receveur */
 			case RECVER :
 
-				/* Le receveur recevra autant de fois que nbRetry l'impose, parce que l'envoyeur enverra tout autant de fois */
-				for(i = 0; i < nbRetry; i++) {
+				/* Le receveur recevra autant de fois que nbRetry (et l'echauffement) l'impose, parce que l'envoyeur enverra tout
+				autant de fois. En mode adaptatif, c'est l'envoyeur (ou tous les envoyeurs, si les tests sont synchronises) qui
+				decide de chaque nouvelle repetition. */
+				for(i = 0; nextTest(&myTest, i, 0, &opts); i++) {
 
 					/* Si c'est une bissection, la reception est bloquee tant qu'un nouveau depart de synchro n'a pas ete donne
 					par le MASTER */
-					if(bissection)
+					if(opts.bissection || opts.concurrent)
 						bissLaunchAllTests();
 
-					/* Si on est pas dans le cas d'un exclu, reponse aux deux tests successifs de l'envoyeur partenaire */
-					if(myTest.role != DEACTIVATED)
-						responsesToTests(&myTest, pktSize);
+					/* Si on est pas dans le cas d'un exclu, reponse aux deux tests successifs de l'envoyeur partenaire, tant
+					que le test n'a pas depasse son delai (option -e) */
+					if(myTest.role != DEACTIVATED && !timedOut && !responsesToTests(&myTest, &opts))
+						timedOut = 1;
 				}
 		}
 
+		/* En mode distribue, seul le resultat d'un envoyeur est garde, pour etre envoye avec les autres a la fin */
+		if(opts.distributed) {
+			if(myTest.role == SENDER) {
+				myResults[nbMyResults] = myResult;
+				memcpy(&mySweeps[nbMyResults * 2 * opts.nbSizes], mySweep, sizeof(float) * 2 * opts.nbSizes);
+				nbMyResults++;
+			}
+
+			/* Apres le dernier tour, envoi de tous les resultats gardes au MASTER, en une seule fonction collective */
+			if(l == rrNbRounds(topo.nbPlayers))
+				distTransmitAllResults(myResults, mySweeps, nbMyResults, NULL, NULL, &opts);
+
 		/* Dans le cas d'une bissection, tous les resultats sont envoyes en meme temps au MASTER, a travers une fonction collective.
 		Les resultats des receveurs ou du desactive ne seront pas pris en compte. */
-		if(bissection)
+		} else if(opts.bissection || opts.concurrent) {
 			bissTransmitAllResults(bissResults, &myResult);
+
+			if(opts.nbSizes > 0)
+				bissTransmitAllSweeps(bissSweeps, mySweep, &opts);
+		}
+	}
+
+	/* Seconde estimation des decalages des horloges, pour corriger leur derive pendant les tests, puis distributions de toutes
+	les repetitions de toutes les paires : chaque noeud y ajoute celles de ses tests d'envoyeur. Si le MASTER a cesse d'attendre
+	un envoyeur (option -e), ces fonctions collectives risqueraient de l'attendre sans fin : il s'en passe, et les resultats
+	sont affiches sans les distributions globales ni la correction des derives */
+	if(nbLost > 0) {
+		histoInit(&latencyStats.histo);
+		histoInit(&flowStats.histo);
+	} else {
+		if(opts.oneWay)
+			clockEnd(rank, nbNodes, &clocks);
+
+		histoReduce(&myLatencyHisto, &latencyStats.histo);
+		histoReduce(&myFlowHisto, &flowStats.histo);
+	}
+
+	/* Le MASTER calcule et affiche les statistiques de tous les resultats recus */
+	if(rank == MASTER) {
+
+		/* Les latences dans chaque sens sont corrigees de la derive des horloges avant toute statistique */
+		if(opts.oneWay) {
+			clockCorrect(&results, &clocks);
+			results.clocks = &clocks;
+		}
+
+		/* Calcul des statistiques */
+		stats(&results, &latencyStats, &flowStats);
+
+		if(opts.window > 0)
+			fieldStats(&results, &streamStats, offsetof(Bench, streamFlow), TOPO_ALL);
+
+		if(opts.bidir) {
+			fieldStats(&results, &bidirStats[0], offsetof(Bench, bidirFlow), TOPO_ALL);
+			fieldStats(&results, &bidirStats[1], offsetof(Bench, bidirOut), TOPO_ALL);
+			fieldStats(&results, &bidirStats[2], offsetof(Bench, bidirIn), TOPO_ALL);
+		}
+
+		if(opts.integrity) {
+			fieldStats(&results, &integrityStats[0], offsetof(Bench, verifiedFlow), TOPO_ALL);
+			fieldStats(&results, &integrityStats[1], offsetof(Bench, corrupted), TOPO_ALL);
+		}
+
+		if(opts.rma != RMA_NONE) {
+			fieldStats(&results, &rmaStats[0], offsetof(Bench, putLatency), TOPO_ALL);
+			fieldStats(&results, &rmaStats[1], offsetof(Bench, putFlow), TOPO_ALL);
+			fieldStats(&results, &rmaStats[2], offsetof(Bench, getLatency), TOPO_ALL);
+			fieldStats(&results, &rmaStats[3], offsetof(Bench, getFlow), TOPO_ALL);
+		}
+
+		if(opts.oneWay) {
+			fieldStats(&results, &oneWayStats[0], offsetof(Bench, oneWayOut), TOPO_ALL);
+			fieldStats(&results, &oneWayStats[1], offsetof(Bench, oneWayIn), TOPO_ALL);
+		}
+
+		if(opts.nbSizes > 0)
+			sweepStatsOf(sweepResults, &sweepStats, nbNodes, &opts);
+
+		/* Latences et debits separes entre liens internes aux machines (memoire partagee) et liens reseau */
+		fieldStats(&results, &classStats[0], offsetof(Bench, latency), TOPO_INTRA);
+		fieldStats(&results, &classStats[1], offsetof(Bench, flow), TOPO_INTRA);
+		fieldStats(&results, &classStats[2], offsetof(Bench, latency), TOPO_INTER);
+		fieldStats(&results, &classStats[3], offsetof(Bench, flow), TOPO_INTER);
+
+		/* Ecriture d'un fichier YAML si l'option -o est passee */
+		if(opts.yaml)
+			toYAML(&results, sweepResults, opts.yamlFile, &opts);
+
+		/* Le fichier binaire est deja complet (option -B) */
+		if(results.binFile != NULL)
+			fclose(results.binFile);
+
+		/* Sortie en coordonnees pour un graphique gnuplot des debits selon des bissections */
+		if(opts.gnuplot) {
+			toGnuplot(&flowStats, nbNodes);
+
+		/* Sinon matrice + stats */
+		} else {
+
+			/* Horloge des mesures, puis affichage d'un tableau/matrice non-parsable sur la sortie standard */
+			timerDescribe(timerInfo);
+			printf("Timer : %s\n", timerInfo);
+			displayTab(&results, &opts);
+
+			/* Affichage des courbes du balayage des tailles, paire par paire */
+			if(opts.nbSizes > 0)
+				displaySweep(&results, sweepResults, &opts);
+
+			/* Affichage des statistiques sur la sortie standard */
+			displayStats(&results, &latencyStats, &flowStats);
+
+			/* Estimations par machine du mode echantillonne */
+			if(opts.sampled)
+				displaySampleHosts(&results);
+
+			if(opts.window > 0)
+				displayFieldStats(&results, &streamStats, offsetof(Bench, streamFlow), "Stream flow", "Mo/s");
+
+			if(opts.bidir) {
+				displayFieldStats(&results, &bidirStats[0], offsetof(Bench, bidirFlow), "Bidirectional flow (sum)", "Mo/s");
+				displayFieldStats(&results, &bidirStats[1], offsetof(Bench, bidirOut), "Bidirectional flow (sender to receiver)", "Mo/s");
+				displayFieldStats(&results, &bidirStats[2], offsetof(Bench, bidirIn), "Bidirectional flow (receiver to sender)", "Mo/s");
+			}
+
+			if(opts.integrity) {
+				displayFieldStats(&results, &integrityStats[0], offsetof(Bench, verifiedFlow), "Verified flow", "Mo/s");
+				displayFieldStats(&results, &integrityStats[1], offsetof(Bench, corrupted), "Corrupted messages", "msg");
+			}
+
+			if(opts.rma != RMA_NONE) {
+				displayFieldStats(&results, &rmaStats[0], offsetof(Bench, putLatency), "RMA put latency", "us");
+				displayFieldStats(&results, &rmaStats[1], offsetof(Bench, putFlow), "RMA put flow", "Mo/s");
+				displayFieldStats(&results, &rmaStats[2], offsetof(Bench, getLatency), "RMA get latency", "us");
+				displayFieldStats(&results, &rmaStats[3], offsetof(Bench, getFlow), "RMA get flow", "Mo/s");
+			}
+
+			if(opts.oneWay) {
+				displayClocks(&clocks, hostnames, nbNodes);
+				displayFieldStats(&results, &oneWayStats[0], offsetof(Bench, oneWayOut), "One-way latency (sender to receiver)", "us");
+				displayFieldStats(&results, &oneWayStats[1], offsetof(Bench, oneWayIn), "One-way latency (receiver to sender)", "us");
+			}
+
+			if(opts.nbSizes > 0)
+				displaySweepStats(&sweepStats, &opts);
+
+			/* Statistiques par classe de liens, si les deux classes ont ete testees */
+			if(classStats[0].nb > 0 && classStats[2].nb > 0) {
+				displayTopology(&topo);
+				displayFieldStats(&results, &classStats[0], offsetof(Bench, latency), "Intra-node latency", "us");
+				displayFieldStats(&results, &classStats[1], offsetof(Bench, flow), "Intra-node flow", "Mo/s");
+				displayFieldStats(&results, &classStats[2], offsetof(Bench, latency), "Inter-node latency", "us");
+				displayFieldStats(&results, &classStats[3], offsetof(Bench, flow), "Inter-node flow", "Mo/s");
+			}
+		}
+
+		/* Inference de la topologie a partir des matrices (option -I), resumee sauf en sortie gnuplot */
+		if(opts.infer)
+			inferTopology(&results, opts.inferFile, !opts.gnuplot);
+
+		/* Placement des ranks d'une application sur le cout mesure des liens (option -G) */
+		if(opts.place != PLACE_NONE)
+			placed = placeRanks(&results, &opts, !opts.gnuplot);
+
+		/* Comparaison avec les resultats de reference */
+		if(opts.compare) {
+			nbRegressions = compareResults(&results, &baseline, &opts);
+			resultsFileUnmap(&baseline);
+		}
+
+		/* Liens dont le test a depasse son delai (option -e) */
+		if(opts.timeout > 0)
+			nbTimeouts = timeoutsSummary(&results, &opts, !opts.gnuplot);
+
+		/* Les ranks qui n'ont pas repondu a temps sont peut-etre bloques : le programme est interrompu plutot que d'attendre
+		leur fin */
+		if(nbLost > 0) {
+			fflush(stdout);
+			MPI_Abort(MPI_COMM_WORLD, 3);
+		}
 	}
 
-	//freee(buffer, bissResults, bissTests, benchResults, sameBenchs, nbNodes, nbRetry);
+	//freee(buffer, bissResults, bissTests, &results, sameBenchs);
 	
 	MPI_Finalize();
 
-	return 0;
+	/* Des regressions par rapport a la reference font echouer le programme (code 2, les erreurs gardant le code 1, comme un
+	placement impossible), puis des liens hors delai (code 3) */
+	return (!placed) ? 1 : (nbRegressions > 0) ? 2 : (nbTimeouts > 0) ? 3 : 0;
 }
 
 
@@ -302,19 +733,97 @@ int main(int argc, char** argv) {
 /*
  * Gestion des options du script
  */
-void initOptions(int argc, char** argv, int nbNodes, int rank, int* pktSize, int* nbRetry, int* bissection, int* randBiss, int* gnuplot, int* yaml, char* yamlFile) {
-	char opt, unit;
+void initOptions(int argc, char** argv, int nbNodes, int rank, Options* o) {
+	char opt, *sep;
+	int min, max, step, mult, valid;
+	PlaceGraph g;
+	long size;
 
 	/* La taille par defaut du mot envoye pour les tests de debit est 1M */
-	*pktSize = 1024 * 1024;
+	o->pktSize = 1024 * 1024;
 
 	/* Le nombre de fois par defaut qu'un test est repete pour ameliore la precision des resultats est 10 */
-	*nbRetry = 10;
+	o->nbRetry = 10;
 
 	/* Par defaut, la bissection (et a forciori la bissection aleatoire) ainsi que le yaml sont desactives */
-	*bissection = *randBiss = *gnuplot = *yaml = 0;
+	o->bissection = o->randBiss = o->gnuplot = o->yaml = 0;
+
+	/* Par defaut, aucun fichier n'est lu ni ecrit */
+	o->yamlFile = o->binFile = o->metricsFile = o->baselineFile = o->inferFile = o->placeGraphFile = o->rankFile = NULL;
+
+	/* Par defaut, le buffer est aligne sur une page, sans pre touche ni rotation */
+	o->bufferPolicy = o->coldSize = 0;
+
+	/* Par defaut, pas de fichier binaire des resultats, ni de comparaison avec une reference (seuil de regression de 10%) */
+	o->bin = o->compare = 0;
+	o->threshold = 10;
+
+	/* Par defaut, la matrice est construite test par test, sans contention entre les paires */
+	o->concurrent = 0;
+
+	/* Par defaut, pas de balayage des tailles de messages */
+	o->nbSizes = 0;
+	o->sizes = NULL;
+
+	/* Par defaut, pas de test de debit en flux continu ; si il est active, 16 fenetres sont envoyees */
+	o->window = 0;
+	o->nbWindows = 16;
+
+	/* Par defaut, les paires ne sont testees que dans un sens a la fois */
+	o->bidir = 0;
+
+	/* Par defaut, le contenu des mots n'est pas verifie */
+	o->integrity = 0;
+
+	/* Par defaut, pas de test RMA */
+	o->rma = RMA_NONE;
+
+	/* Par defaut, les tests de la matrice concurrente sont distribues par le MASTER */
+	o->distributed = 0;
+	o->seed = 0;
+
+	/* Par defaut, la matrice est complete (pas d'echantillonnage des partenaires) */
+	o->sampled = 0;
+	o->shifts = NULL;
+
+	/* Par defaut, tous les ranks et tous les liens sont testes */
+	o->topology = TOPO_ALL;
 
-	while((opt = getopt(argc, argv, "hs:p:bro:g")) != -1) {
+	/* Par defaut, pas de surveillance continue, et une derive au dela de 50% de la reference d'un lien est signalee */
+	o->monitor = o->monitorCount = o->metrics = 0;
+	o->drift = 50;
+
+	/* Par defaut, pas de test incast/outcast */
+	o->fan = 0;
+
+	/* Par defaut, pas de test des operations collectives */
+	o->collectives = 0;
+
+	/* Par defaut, pas de test multi threads */
+	o->threads = 0;
+
+	/* Par defaut, la latence est la moitie de l'aller-retour */
+	o->oneWay = 0;
+
+	/* Par defaut, les mesures sont faites avec MPI_Wtime */
+	o->timer = TIMER_WTIME;
+
+	/* Par defaut, pas de test de latence sous charge */
+	o->loaded = 0;
+
+	/* Par defaut, pas d'inference de la topologie ni de placement des ranks */
+	o->infer = 0;
+	o->place = PLACE_NONE;
+
+	/* Par defaut, une repetition d'echauffement est ignoree avant chaque test, et le nombre de repetitions est fixe (-p) */
+	o->warmup = 1;
+	o->target = 0;
+	o->maxRetry = 100;
+
+	/* Par defaut, les tests n'ont pas de delai */
+	o->timeout = 0;
+
+	while((opt = getopt(argc, argv, "hs:p:bro:B:R:T:gcl:t:m:M:D:P:S:w:W:dix:u:a:A:e:f:Cn:Ok:L:I:G:K:")) != -1) {
 		switch(opt) {
 
 			/* Help */
@@ -323,11 +832,80 @@ void initOptions(int argc, char** argv, int nbNodes, int rank, int* pktSize, int
 					puts("\nOAR FLOW LATENCY TESTS");
 					puts("------------------------");
 					puts("\t-s <n>K   : Message size for flow tests exchanges, in bytes (with K, M, or G suffix). Min 64K, default 1M.");
-					puts("\t-p <n>    : Tests precision (repeats each test <n> times and make averages). Default 10.");
+					puts("\t-S <min>:<max>[:<x>] : Message size sweep, from <min> to <max> bytes (K, M, G suffixes allowed), multiplying by <x>");
+					puts("\t            (default 2) or adding <x> if prefixed by '+' (ex. 8:16M, 1K:1M:4, 64K:1M:+64K).");
+					puts("\t-w <n>    : Streaming flow test, keeping a window of <n> nonblocking sends in flight (one ack per window).");
+					puts("\t-W <n>    : Number of windows sent by the streaming flow test. Default 16.");
+					puts("\t-P <list> : Buffer policy, comma separated: page (page aligned, default), huge (huge page aligned, hugetlbfs");
+					puts("\t            or transparent huge pages), prefault (touched before the tests), cold[:<size>] (each repetition");
+					puts("\t            uses the next buffer of a region of <size> bytes, default twice the last level cache; implies");
+					puts("\t            prefault, so that the first pass measures cache misses and not page faults).");
+					puts("\t-d        : Bidirectional flow test (both ranks of a pair send <n>K to each other at the same time).");
+					puts("\t-i        : Integrity test: a pattern message ending with its CRC32C is checked by the receiver before its ack.");
+					puts("\t            Shows the flow with the check included and the number of corrupted messages per link.");
+					puts("\t-x <sync> : One-sided (RMA) test: latency and flow of MPI_Put and MPI_Get into a window of the receiver,");
+					puts("\t            synchronized by fence, pscw (post/start/complete/wait) or lock (passive target, lock/flush).");
+					puts("\t-O        : One-way latency in each direction, with the clock of each rank compared to the master clock");
+					puts("\t            (shortest of 32 round trips) before and after the tests, to correct its offset and drift.");
+					puts("\t            Shows the offset, its uncertainty and the drift of each host.");
+					puts("\t-k <clock>: Timer of the measures: wtime (MPI_Wtime, default), raw (clock_gettime CLOCK_MONOTONIC_RAW) or");
+					puts("\t            tsc (invariant TSC, calibrated at startup). The cost of a timer read, measured at startup,");
+					puts("\t            is subtracted from each duration. The timer and its resolution are shown with the results.");
+					puts("\t-p <n>    : Tests precision (repeats each test <n> times, keeps the medians and the distributions). Default 10.");
+					puts("\t-u <n>    : Warm-up repetitions run and discarded before each test. Default 1.");
+					puts("\t-a <pct>  : Adaptive precision: after the -p repetitions, repeats each test until the 95% confidence interval");
+					puts("\t            of the latency and flow medians is within <pct> percent of them.");
+					puts("\t-A <n>    : Maximum repetitions of a test in adaptive mode. Default 100.");
+					puts("\t-e <sec>  : Timeout of each test, all repetitions included: a test still running after <sec> seconds is");
+					puts("\t            abandoned and its link flagged, keeping the repetitions done in time. A rank that does not");
+					puts("\t            send its result to the master in time aborts the run after the results. Exits with code 3");
+					puts("\t            if a link timed out.");
+					puts("\t-f <K>    : Incast and outcast test: K nodes send a message of -s bytes to the first node at once, then");
+					puts("\t            it sends one to each of them at once, with 1, 2, 4... up to K nodes. Shows the flow of each");
+					puts("\t            transfer, the aggregate flow and the Jain fairness index.");
+					puts("\t-L <n>    : Loaded latency test: the first 2n nodes form n probe pairs, which measure 100 x -p small message");
+					puts("\t            latencies on an idle network, then while the other nodes, paired as in -b, stream messages of");
+					puts("\t            -s bytes. Shows the latency inflation (loaded / idle) of each probe link, and the bulk flows.");
+					puts("\t-C        : Collectives test: Bcast, Reduce, Allreduce, Allgather, Alltoall and Barrier between all nodes but");
+					puts("\t            the master, over the -S sweep (default 8 bytes to -s bytes, x8). Shows the time of the slowest");
+					puts("\t            rank and the slowest rank of each operation, and from the entry dates of the ranks on the");
+					puts("\t            master clock (see -O), the arrival skew and the rank that arrives last.");
+					puts("\t-n <T>    : Multi-threaded flow test (MPI_THREAD_MULTIPLE): the bisection pairs (see -b) stream -p messages of");
+					puts("\t            -s bytes with 1, 2, 4... up to T threads per rank, each on its own communicator. Shows the flow of");
+					puts("\t            each thread, the aggregate flow of the pair and its scaling from one thread.");
 					puts("\t-b        : Bisection (first node of the first half with the first node of the seconde half, and so on).");
 					puts("\t-rb, -r   : Bisection, with random pairs.");
 					puts("\t-bg, -g   : Bisection, with gnuplot coordinates output.");
+					puts("\t-c        : Concurrent matrix (disjoint pairs tested at the same time, round-robin schedule). Default is serial.");
+					puts("\t-l <seed> : Distributed concurrent matrix (implies -c): each node computes its own round-robin schedule,");
+					puts("\t            with the nodes shuffled by <seed> (0 for a seed taken from the clock), and keeps its results");
+					puts("\t            until the end. The master only starts the rounds, then gathers all results at once.");
+					puts("\t-K <k>[:<seed>] : Sampled matrix: each rank is tested against <k> partners only, at <k> distinct shifts in the list");
+					puts("\t            of tested ranks drawn from <seed> (0 or none for a seed taken from the clock), so that every rank sends");
+					puts("\t            and receives <k> times. N*K tests (3K rounds with -c) instead of N(N-1); shows the tested links and");
+					puts("\t            per-host mean latency and flow with their 95% confidence intervals. Not with -b or -l.");
+					puts("\t-t <set>  : Tested ranks and links, with ranks grouped by host (shared memory): all (default), leaders");
+					puts("\t            (one rank per host), intra (links inside a host only) or inter (links between hosts only).");
+					puts("\t            Latency and flow stats are also shown per class when both were tested.");
+					puts("\t-m <T>[:<n>] : Monitoring: tests one round of the distributed concurrent matrix (see -l) every <T> seconds,");
+					puts("\t            <n> times (default 0, endless). Keeps the last results of each link and flags the links whose");
+					puts("\t            latency or flow drifts from the median of their previous results.");
+					puts("\t-M <file> : Monitoring metrics, rewritten each round in Prometheus text format if <file> ends with .prom,");
+					puts("\t            else appended as JSON lines (one per link tested in the round).");
+					puts("\t-D <pct>  : Monitoring drift threshold, in percent of the link baseline. Default 50.");
 					puts("\t-o <file> : YAML output.");
+					puts("\t-B <file> : Binary results output, appended as each result arrives (see bwlat_convert -h).");
+					puts("\t-I <file> : Infers the network tree from the latency and flow matrix (single linkage clustering of the hosts,");
+					puts("\t            one level per gap in the merge distances), written as DOT if <file> ends with .dot, else YAML.");
+					puts("\t            Hosts that do not fit their group are flagged.");
+					puts("\t-G <pattern>:<rankfile> : Places the ranks of an application on the tested ranks to minimize the");
+					puts("\t            measured cost of its communication pattern: ring, stencil2d, stencil3d (grid neighbours, not");
+					puts("\t            periodic) or a graph file of \"<rank> <rank> [<weight>]\" lines. Greedy placement refined by");
+					puts("\t            pair swaps, written as an Open MPI rankfile (mpirun --rankfile) with one line per rank.");
+					puts("\t-R <file> : Compares the results with a previous binary results file (-B), link by link and host by host.");
+					puts("\t            Exits with code 2 if a link is worse by more than the -T threshold, with a significant");
+					puts("\t            difference (Welch test on the repetitions).");
+					puts("\t-T <pct>  : Regression threshold of -R, in percent of the previous latency or flow. Default 10.");
 					puts("\t-h        : This help.\n");
 					puts("AUTHORS : <julien@vaubourg.com>\n          <sebastien.badia@gmail.com>\n");
 				}
@@ -338,32 +916,17 @@ void initOptions(int argc, char** argv, int nbNodes, int rank, int* pktSize, int
 
 			/* Taille des mots qui seront envoyes pour les tests de debit, en octets et avec un suffix (K, M, G) */
 			case 's' :
+				o->pktSize = parseSize(optarg);
 
-				/* Recuperation de l'unite utilisee en recuperant le dernier caractere de la valeur (nK, nM, ou nG), puis suppression de celle-ci */
-				unit = optarg[strlen(optarg) - 1];
-				*(strchr(optarg, unit)) = '\0';
-				*pktSize = atoi(optarg);
-
-				/* En l'absence de break intermediaires, la taille du mot sera multipliee par autant de fois qu'il faudra traverser une unite
-				subalterne pour atteindre le break final. */
-				switch(unit) {
-					case 'G' :
-						*pktSize *= 1024;
-					case 'M' :
-						*pktSize *= 1024;
-					case 'K' :
-						*pktSize *= 1024;
-					break;
-
-					default :
-						if(rank == MASTER)
-							fprintf(stderr, "ERROR: Unit -s unknown (K, M, or G).");
+				if(o->pktSize == -1) {
+					if(rank == MASTER)
+						fprintf(stderr, "ERROR: Unit -s unknown (K, M, or G).");
 
-						exit(1);
+					exit(1);
 				}
 
 				/* Un calcul de debit ne peut pas se faire avec un mot de moins de 64K (tests NWS) */
-				if(*pktSize < 64*1024) {
+				if(o->pktSize < 64*1024) {
 					if(rank == MASTER)
 						fprintf(stderr, "ERROR: For realistic flows results, the message size defined by -s must be greater than 64KB (NWS method).");
 
@@ -371,671 +934,5948 @@ void initOptions(int argc, char** argv, int nbNodes, int rank, int* pktSize, int
 				}
 			break;
 
-			/* Mode bissection : couples aleatoires si -r, en fonction de la moitiee de la liste des noeuds sinon */
-			case 'r' :
-				*randBiss = 1;
-			case 'b' :
-				*bissection = 1;
-			break;
+			/* Balayage des tailles de messages : <min>:<max>[:<x>], chaque taille etant multipliee par x (ou augmentee de x si +x) */
+			case 'S' :
+				mult = 1;
+				step = 2;
 
-			/* Sortie pour un graphique gnuplot */
-			case 'g' :
-				*gnuplot = 1;
-				*bissection = 1;
-			break;
+				/* Decoupage de la chaine, en partant de la fin (pas optionnel) */
+				if((sep = strchr(optarg, ':')) == NULL) {
+					if(rank == MASTER)
+						fprintf(stderr, "ERROR: The -S option must be <min>:<max>[:<x>].");
 
-			/* Sortie dans un fichier YAML en plus de la sortie matrice */
-			case 'o' :
-				*yaml = 1;
-				strncpy(yamlFile, optarg, 50);
-			break;
+					exit(1);
+				}
 
-			/* Les tests se feront autant de fois que l'indicateur de precision -p le dit, en prenant la moyenne des resultats de tous */
-			case 'p' :
-				*nbRetry = atoi(optarg);
+				*sep = '\0';
+				min = parseSize(optarg);
+				optarg = sep + 1;
+
+				if((sep = strchr(optarg, ':')) != NULL) {
+					*sep = '\0';
 
-				if(*nbRetry < 0) {
+					if(sep[1] == '+') {
+						mult = 0;
+						sep++;
+					}
+
+					step = parseSize(sep + 1);
+				}
+
+				max = parseSize(optarg);
+
+				if(min < 1 || max < min || step < (mult ? 2 : 1)) {
 					if(rank == MASTER)
-						fprintf(stderr, "ERROR: The -p option must be positive.");
+						fprintf(stderr, "ERROR: Invalid -S sweep (sizes must be positive, increasing, with a factor of 2 or more).");
 
 					exit(1);
 				}
-			break;
 
-			/* Option inconnue ou mal renseignee */
-			case '?' :
-				if(rank == MASTER) {
-					if(optopt == 's' || optopt == 'r' || optopt == 'o')
-						fprintf(stderr, "ERROR: The -%c option require an argument.\n", optopt);
-					else if(isprint(optopt))
-						fprintf(stderr, "ERROR: The -%c option is unknown.\n", optopt);
-					else
-						fprintf(stderr, "ERROR: The '\\x%x' character is unknown.\n", optopt);
+				/* Calcul du nombre de tailles, puis remplissage de la liste */
+				for(o->nbSizes = 0, size = min; size <= max; o->nbSizes++)
+					size = mult ? size * step : size + step;
+
+				o->sizes = (int*) malloc(sizeof(int) * o->nbSizes);
+
+				if(o->sizes == NULL) {
+					fprintf(stderr, "ERROR: Can't allocate memory.");
+					exit(1);
 				}
-			default:
-				exit(1);
-		}
-	}
 
-	if(nbNodes < 3) {
-		if(rank == MASTER)
-			fprintf(stderr, "ERROR : Tests requires at least 3 nodes (1 for monitoring, at least 2 for exchanges).");
+				for(o->nbSizes = 0, size = min; size <= max; o->nbSizes++) {
+					o->sizes[o->nbSizes] = size;
+					size = mult ? size * step : size + step;
+				}
+			break;
 
-		exit(1);
-	}
-}
+			/* Test de debit en flux continu : profondeur de la fenetre d'envois non bloquants, et nombre de fenetres */
+			case 'w' :
+			case 'W' :
+				if(atoi(optarg) < 1) {
+					if(rank == MASTER)
+						fprintf(stderr, "ERROR: The -%c option must be at least 1.", opt);
 
-/*
- * Creation d'un type BenchType pour MPI qui permettra de faire transiter des structures Bench d'un noeud a l'autre.
- */
-void createBenchType() {
-	MPI_Type_extent(MPI_INT, &extentType);
+					exit(1);
+				}
 
-	benchTypeDisp[0] = 0;
-	benchTypeDisp[1] = extentType;
-	benchTypeDisp[2] = extentType*2;
+				*(opt == 'w' ? &o->window : &o->nbWindows) = atoi(optarg);
+			break;
 
-	MPI_Type_extent(MPI_FLOAT, &extentType);
+			/* Test de debit bidirectionnel, en plus des tests dans un seul sens */
+			case 'd' :
+				o->bidir = 1;
+			break;
 
-	benchTypeDisp[3] = benchTypeDisp[2] + extentType;
+			/* Test d'integrite : motif et CRC32C verifie par le receveur */
+			case 'i' :
+				o->integrity = 1;
+			break;
 
-	MPI_Type_struct(4, benchTypeBlocks, benchTypeDisp, benchTypeTypes, &BenchType);
-	MPI_Type_commit(&BenchType);
-}
+			/* Tests RMA (Put et Get), avec la synchronisation choisie */
+			case 'x' :
+				if(strcmp(optarg, "fence") == 0)
+					o->rma = RMA_FENCE;
+				else if(strcmp(optarg, "pscw") == 0)
+					o->rma = RMA_PSCW;
+				else if(strcmp(optarg, "lock") == 0)
+					o->rma = RMA_LOCK;
+				else {
+					if(rank == MASTER)
+						fprintf(stderr, "ERROR: The -x option must be fence, pscw or lock.");
 
-/*
- * Creation d'un type TestType pour MPI qui permettra de faire transiter des structures YourTest d'un noeud a l'autre.
+					exit(1);
+				}
+			break;
+
+			/* Repetitions d'echauffement, dont les resultats sont ignores */
+			case 'u' :
+				o->warmup = atoi(optarg);
+
+				if(o->warmup < 0) {
+					if(rank == MASTER)
+						fprintf(stderr, "ERROR: The -u option must be positive.");
+
+					exit(1);
+				}
+			break;
+
+			/* Mode adaptatif : precision visee sur les medianes, en pourcentage, et nombre maximum de repetitions */
+			case 'a' :
+				o->target = atof(optarg);
+
+				if(o->target <= 0) {
+					if(rank == MASTER)
+						fprintf(stderr, "ERROR: The -a option must be a positive percentage.");
+
+					exit(1);
+				}
+			break;
+
+			/* Delai de chaque test, en secondes */
+			case 'e' :
+				o->timeout = atof(optarg);
+
+				if(o->timeout <= 0) {
+					if(rank == MASTER)
+						fprintf(stderr, "ERROR: The -e option must be a positive number of seconds.");
+
+					exit(1);
+				}
+			break;
+
+			case 'A' :
+				o->maxRetry = atoi(optarg);
+
+				if(o->maxRetry < 1) {
+					if(rank == MASTER)
+						fprintf(stderr, "ERROR: The -A option must be at least 1.");
+
+					exit(1);
+				}
+			break;
+
+			/* Test incast/outcast, avec au plus K noeuds face au premier */
+			case 'f' :
+				o->fan = atoi(optarg);
+
+				if(o->fan < 1 || o->fan > nbNodes - 2) {
+					if(rank == MASTER)
+						fprintf(stderr, "ERROR: The -f option must be between 1 and the number of nodes minus 2 (%d).", nbNodes - 2);
+
+					exit(1);
+				}
+			break;
+
+			/* Test multi threads, avec au plus T threads par rank */
+			case 'n' :
+				o->threads = atoi(optarg);
+
+				if(o->threads < 1) {
+					if(rank == MASTER)
+						fprintf(stderr, "ERROR: The -n option must be at least 1.");
+
+					exit(1);
+				}
+			break;
+
+			/* Horloge des mesures */
+			case 'k' :
+				if(strcmp(optarg, "wtime") == 0)
+					o->timer = TIMER_WTIME;
+				else if(strcmp(optarg, "raw") == 0)
+					o->timer = TIMER_RAW;
+				else if(strcmp(optarg, "tsc") == 0)
+					o->timer = TIMER_TSC;
+				else {
+					if(rank == MASTER)
+						fprintf(stderr, "ERROR: The -k option must be wtime, raw or tsc.");
+
+					exit(1);
+				}
+			break;
+
+			/* Latence dans chaque sens */
+			case 'O' :
+				o->oneWay = 1;
+			break;
+
+			/* Latence sous charge, avec n paires sondes */
+			case 'L' :
+				o->loaded = atoi(optarg);
+
+				if(o->loaded < 1 || 2 * o->loaded + 2 > nbNodes - 1) {
+					if(rank == MASTER)
+						fprintf(stderr, "ERROR: The -L option must be between 1 and the number of nodes minus 3, halved (%d).", (nbNodes - 3) / 2);
+
+					exit(1);
+				}
+			break;
+
+			/* Test des operations collectives */
+			case 'C' :
+				o->collectives = 1;
+			break;
+
+			/* Mode bissection : couples aleatoires si -r, en fonction de la moitiee de la liste des noeuds sinon */
+			case 'r' :
+				o->randBiss = 1;
+			case 'b' :
+				o->bissection = 1;
+			break;
+
+			/* Sortie pour un graphique gnuplot */
+			case 'g' :
+				o->gnuplot = 1;
+				o->bissection = 1;
+			break;
+
+			/* Matrice concurrente : tournoi round-robin au lieu des tests un par un */
+			case 'c' :
+				o->concurrent = 1;
+			break;
+
+			/* Matrice concurrente distribuee : chaque noeud calcule son propre ordonnancement, a partir de la graine du MASTER
+			(tiree de l'heure si elle vaut 0) */
+			case 'l' :
+				o->distributed = o->concurrent = 1;
+				o->seed = (unsigned int) atol(optarg);
+
+				if(o->seed == 0)
+					o->seed = (unsigned int) time(NULL);
+			break;
+
+			/* Matrice echantillonnee : K partenaires par rank, tires de la graine du MASTER (de l'heure si elle vaut 0) */
+			case 'K' :
+				if(sscanf(optarg, "%d:%u", &o->sampled, &o->seed) < 1 || o->sampled < 1) {
+					if(rank == MASTER)
+						fprintf(stderr, "ERROR: The -K option must be <partners>[:<seed>], with at least one partner.");
+
+					exit(1);
+				}
+
+				if(o->seed == 0)
+					o->seed = (unsigned int) time(NULL);
+			break;
+
+			/* Surveillance continue : un tour de la matrice distribuee toutes les T secondes, count fois (0 sans fin) */
+			case 'm' :
+				o->distributed = o->concurrent = 1;
+
+				if(sscanf(optarg, "%d:%d", &o->monitor, &o->monitorCount) < 1 || o->monitor < 1 || o->monitorCount < 0) {
+					if(rank == MASTER)
+						fprintf(stderr, "ERROR: The -m option must be <seconds>[:<count>], with at least one second.");
+
+					exit(1);
+				}
+
+				if(o->seed == 0)
+					o->seed = (unsigned int) time(NULL);
+			break;
+
+			/* Fichier des metriques de la surveillance */
+			case 'M' :
+				o->metrics = 1;
+				o->metricsFile = optarg;
+			break;
+
+			/* Seuil de derive d'un lien par rapport a sa reference, en pourcentage */
+			case 'D' :
+				o->drift = atof(optarg);
+
+				if(o->drift <= 0) {
+					if(rank == MASTER)
+						fprintf(stderr, "ERROR: The -D option must be positive.");
+
+					exit(1);
+				}
+			break;
+
+			/* Ranks et liens testes selon les machines */
+			case 't' :
+				if(strcmp(optarg, "all") == 0)
+					o->topology = TOPO_ALL;
+				else if(strcmp(optarg, "leaders") == 0)
+					o->topology = TOPO_LEADERS;
+				else if(strcmp(optarg, "intra") == 0)
+					o->topology = TOPO_INTRA;
+				else if(strcmp(optarg, "inter") == 0)
+					o->topology = TOPO_INTER;
+				else {
+					if(rank == MASTER)
+						fprintf(stderr, "ERROR: The -t option must be all, leaders, intra or inter.");
+
+					exit(1);
+				}
+			break;
+
+			/* Sortie dans un fichier YAML en plus de la sortie matrice */
+			case 'o' :
+				o->yaml = 1;
+				o->yamlFile = optarg;
+			break;
+
+			/* Sortie dans un fichier binaire, ecrit au fil des tests */
+			case 'B' :
+				o->bin = 1;
+				o->binFile = optarg;
+			break;
+
+			/* Inference de la topologie */
+			case 'I' :
+				o->infer = 1;
+				o->inferFile = optarg;
+			break;
+
+			/* Placement des ranks : <schema>:<rankfile>, le schema etant ring, stencil2d, stencil3d ou un fichier de graphe */
+			case 'G' :
+				sep = strrchr(optarg, ':');
+
+				if(sep == NULL || sep == optarg || sep[1] == '\0') {
+					if(rank == MASTER)
+						fprintf(stderr, "ERROR: The -G option must be <pattern>:<rankfile>, with ring, stencil2d, stencil3d or a graph file as pattern.");
+
+					exit(1);
+				}
+
+				*sep = '\0';
+				o->rankFile = sep + 1;
+
+				if(strcmp(optarg, "ring") == 0)
+					o->place = PLACE_RING;
+				else if(strcmp(optarg, "stencil2d") == 0)
+					o->place = PLACE_STENCIL2D;
+				else if(strcmp(optarg, "stencil3d") == 0)
+					o->place = PLACE_STENCIL3D;
+				else {
+					o->place = PLACE_GRAPH;
+					o->placeGraphFile = optarg;
+				}
+			break;
+
+			/* Comparaison avec les resultats de reference d'un fichier binaire */
+			case 'R' :
+				o->compare = 1;
+				o->baselineFile = optarg;
+			break;
+
+			/* Politique des buffers : liste de page, huge, prefault et cold[:<taille>] separes par des virgules */
+			case 'P' :
+				for(sep = strtok(optarg, ","); sep != NULL; sep = strtok(NULL, ",")) {
+					if(strcmp(sep, "huge") == 0)
+						o->bufferPolicy |= BUFFER_HUGE;
+					else if(strcmp(sep, "prefault") == 0)
+						o->bufferPolicy |= BUFFER_PREFAULT;
+					else if(strncmp(sep, "cold", 4) == 0 && (sep[4] == '\0' || sep[4] == ':')) {
+						/* La reserve est toujours pre touchee en mode cold : son premier parcours ne doit pas mesurer
+						des defauts de page au lieu des defauts de cache */
+						o->bufferPolicy |= BUFFER_COLD | BUFFER_PREFAULT;
+						o->coldSize = (sep[4] == ':') ? parseSize(sep + 5) : coldDefaultSize();
+					} else if(strcmp(sep, "page") != 0)
+						o->coldSize = -1;
+
+					if(o->coldSize < 0) {
+						if(rank == MASTER)
+							fprintf(stderr, "ERROR: The -P option must be a list of page, huge, prefault and cold[:<size>].");
+
+						exit(1);
+					}
+				}
+			break;
+
+			/* Seuil de regression, en pourcentage */
+			case 'T' :
+				o->threshold = atof(optarg);
+
+				if(o->threshold < 0) {
+					if(rank == MASTER)
+						fprintf(stderr, "ERROR: The -T option must be positive.");
+
+					exit(1);
+				}
+			break;
+
+			/* Les tests se feront autant de fois que l'indicateur de precision -p le dit, en prenant la moyenne des resultats de tous */
+			case 'p' :
+				o->nbRetry = atoi(optarg);
+
+				if(o->nbRetry < 0) {
+					if(rank == MASTER)
+						fprintf(stderr, "ERROR: The -p option must be positive.");
+
+					exit(1);
+				}
+			break;
+
+			/* Option inconnue ou mal renseignee */
+			case '?' :
+				if(rank == MASTER) {
+					if(strchr(OPTIONS_WITH_ARG, optopt) != NULL)
+						fprintf(stderr, "ERROR: The -%c option require an argument.\n", optopt);
+					else if(isprint(optopt))
+						fprintf(stderr, "ERROR: The -%c option is unknown.\n", optopt);
+					else
+						fprintf(stderr, "ERROR: The '\\x%x' character is unknown.\n", optopt);
+				}
+			default:
+				exit(1);
+		}
+	}
+
+	if(nbNodes < 3) {
+		if(rank == MASTER)
+			fprintf(stderr, "ERROR : Tests requires at least 3 nodes (1 for monitoring, at least 2 for exchanges).");
+
+		exit(1);
+	}
+
+	/* Le mode echantillonne remplace la matrice classique ou concurrente, pas la bissection ni l'ordonnancement distribue */
+	if(o->sampled && (o->bissection || o->distributed)) {
+		if(rank == MASTER)
+			fprintf(stderr, "ERROR: The -K option can't be used with -b, -r, -g, -l or -m.");
+
+		exit(1);
+	}
+
+	/* Le graphe du placement (option -G) est lu par le MASTER des maintenant, avec les ranks de l'application bornes par le
+	nombre de ranks testes au plus (nbNodes-1) : un fichier absent ou invalide n'attend pas la fin des tests */
+	if(o->place == PLACE_GRAPH) {
+		valid = (rank != MASTER) || placeGraph(&g, nbNodes - 1, o);
+		MPI_Bcast(&valid, 1, MPI_INT, MASTER, MPI_COMM_WORLD);
+
+		if(!valid)
+			exit(1);
+
+		if(rank == MASTER) {
+			free(g.first);
+			free(g.adj);
+			free(g.weight);
+		}
+	}
+
+	/* Sans balayage (option -S), les collectives sont testees de 8 octets a la taille des mots de debit */
+	if(o->collectives && o->nbSizes == 0)
+		collDefaultSizes(o);
+}
+
+/*
+ * Taille du buffer d'envoi et de reception, en octets : le plus gros mot echange, ou une fenetre complete du flux continu (le
+ * receveur y poste une reception par mot de la fenetre, chacune dans sa propre zone).
+ */
+size_t bufferSize(Options* o) {
+	size_t size = o->pktSize;
+
+	if(o->nbSizes > 0 && (size_t) o->sizes[o->nbSizes-1] > size)
+		size = o->sizes[o->nbSizes-1];
+
+	/* Les produits sont calcules en size_t : une grande fenetre de grands mots depasse facilement 2 Go */
+	if((size_t) o->window * o->pktSize > size)
+		size = (size_t) o->window * o->pktSize;
+
+	/* Le test bidirectionnel recoit dans la seconde moitie du buffer pendant qu'il envoie la premiere */
+	if(o->bidir && 2 * (size_t) o->pktSize > size)
+		size = 2 * (size_t) o->pktSize;
+
+	/* En incast, le premier noeud recoit les K mots en meme temps, chacun dans sa zone */
+	if((size_t) o->fan * o->pktSize > size)
+		size = (size_t) o->fan * o->pktSize;
+
+	return size;
+}
+
+/*
+ * Allocation de la reserve des buffers selon la politique de l'option -P. Elle est alignee sur une page (ou une grande page de
+ * HUGE_PAGE_SIZE octets avec huge : hugetlbfs si des pages sont reservees, sinon pages transparentes via madvise), et pre
+ * touchee avec prefault pour que les defauts de page ne tombent pas dans les mesures. En mode cold, elle compte assez
+ * d'emplacements de bufferSize octets pour depasser o->coldSize, et chaque repetition passe au suivant (voir bufferNext) :
+ * aucun mot n'est alors deja dans le cache du processeur.
+ */
+void bufferAlloc(Options* o) {
+	size_t align, poolSize;
+	int fallback = 0, anyFallback;
+	void* pool = NULL;
+
+	align = (o->bufferPolicy & BUFFER_HUGE) ? HUGE_PAGE_SIZE : (size_t) sysconf(_SC_PAGESIZE);
+	bufferSlotSize = (bufferSize(o) + align - 1) / align * align;
+	bufferNbSlots = 1;
+
+	if(o->bufferPolicy & BUFFER_COLD) {
+		bufferNbSlots = (o->coldSize + bufferSlotSize - 1) / bufferSlotSize + 1;
+
+		if(bufferNbSlots < 2)
+			bufferNbSlots = 2;
+	}
+
+	poolSize = bufferSlotSize * bufferNbSlots;
+
+	if(o->bufferPolicy & BUFFER_HUGE) {
+		pool = mmap(NULL, poolSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+		if(pool == MAP_FAILED) {
+			pool = NULL;
+			fallback = 1;
+
+			if(posix_memalign(&pool, align, poolSize) == 0)
+				madvise(pool, poolSize, MADV_HUGEPAGE);
+			else
+				pool = NULL;
+		}
+
+	} else if(posix_memalign(&pool, align, poolSize) != 0)
+		pool = NULL;
+
+	if(pool == NULL) {
+		fprintf(stderr, "ERROR: Can't allocate memory.");
+		exit(1);
+	}
+
+	if(o->bufferPolicy & BUFFER_PREFAULT)
+		memset(pool, 0, poolSize);
+
+	/* Politique effective, identique pour tous : pages transparentes si un des noeuds n'a pas eu de pages hugetlbfs */
+	MPI_Allreduce(&fallback, &anyFallback, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+
+	if(anyFallback)
+		o->bufferPolicy |= BUFFER_THP;
+
+	bufferPool = (char*) pool;
+	bufferSlot = 0;
+	buffer = (int*) bufferPool;
+}
+
+/*
+ * Passage du buffer courant a l'emplacement suivant de la reserve, avant chaque repetition (sans effet hors mode cold).
+ */
+void bufferNext() {
+	bufferSlot = (bufferSlot + 1) % bufferNbSlots;
+	buffer = (int*) (bufferPool + (size_t) bufferSlot * bufferSlotSize);
+}
+
+/*
+ * Nom de la politique des buffers, tel qu'il est rappele dans les sorties (ex. "huge,prefault,cold:64M").
+ */
+void bufferPolicyName(char* str, Options* o) {
+	char size[16];
+
+	strcpy(str, (o->bufferPolicy & BUFFER_THP) ? "thp" : ((o->bufferPolicy & BUFFER_HUGE) ? "huge" : "page"));
+
+	if(o->bufferPolicy & BUFFER_PREFAULT)
+		strcat(str, ",prefault");
+
+	if(o->bufferPolicy & BUFFER_COLD) {
+		formatSize(size, o->coldSize);
+		strcat(str, ",cold:");
+		strcat(str, size);
+	}
+}
+
+/*
+ * Taille par defaut de la zone parcourue en mode cold : deux fois le dernier niveau de cache, ou COLD_DEFAULT_SIZE si il est
+ * inconnu.
+ */
+int coldDefaultSize() {
+	long llc = 0;
+
+#ifdef _SC_LEVEL3_CACHE_SIZE
+	llc = sysconf(_SC_LEVEL3_CACHE_SIZE);
+
+	if(llc <= 0)
+		llc = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+
+	return (llc > 0) ? 2 * llc : COLD_DEFAULT_SIZE;
+}
+
+/*
+ * Conversion d'une taille en octets, eventuellement suffixee par une unite (K, M ou G). Renvoie -1 si l'unite est inconnue.
+ */
+int parseSize(char* str) {
+	int size;
+	char unit;
+
+	size = atoi(str);
+	unit = str[strlen(str) - 1];
+
+	/* En l'absence de break intermediaires, la taille du mot sera multipliee par autant de fois qu'il faudra traverser une unite
+	subalterne pour atteindre le break final. */
+	switch(unit) {
+		case 'G' :
+			size *= 1024;
+		case 'M' :
+			size *= 1024;
+		case 'K' :
+			size *= 1024;
+		break;
+
+		default :
+			if(unit < '0' || unit > '9')
+				return -1;
+	}
+
+	return size;
+}
+
+/*
+ * Preparation de l'horloge des mesures (option -k) sur chaque noeud : resolution annoncee (MPI_Wtick, clock_getres, ou duree
+ * d'un tic du TSC apres son etalonnage), puis cout d'une lecture. Le MASTER recoit la pire resolution et le pire cout de tous
+ * les noeuds, qui accompagnent les resultats (voir timerDescribe).
+ */
+void timerInit(int rank, Options* o) {
+	struct timespec res;
+	double values[2], worst[2];
+
+	timer.backend = o->timer;
+	timer.overhead = 0;
+
+	switch(o->timer) {
+		case TIMER_RAW :
+			clock_getres(CLOCK_MONOTONIC_RAW, &res);
+			timer.resolution = res.tv_sec + res.tv_nsec / 1e9;
+		break;
+
+		case TIMER_TSC :
+			if(!tscInvariant()) {
+				fprintf(stderr, "ERROR: The -k tsc option requires an invariant TSC (rank %d).", rank);
+				exit(1);
+			}
+
+			timer.tscPeriod = tscCalibrate();
+			timer.resolution = timer.tscPeriod;
+		break;
+
+		default :
+			timer.resolution = MPI_Wtick();
+	}
+
+	timer.overhead = timerCalibrate();
+
+	values[0] = timer.resolution;
+	values[1] = timer.overhead;
+	MPI_Reduce(values, worst, 2, MPI_DOUBLE, MPI_MAX, MASTER, MPI_COMM_WORLD);
+	timerWorst.backend = o->timer;
+
+	if(rank == MASTER) {
+		timerWorst.resolution = worst[0];
+		timerWorst.overhead = worst[1];
+	}
+}
+
+/*
+ * Date courante en secondes, selon l'horloge choisie. Les dates de deux noeuds differents ne sont pas comparables (voir -O).
+ */
+double timerNow() {
+	struct timespec now;
+
+	switch(timer.backend) {
+		case TIMER_RAW :
+			clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+			return now.tv_sec + now.tv_nsec / 1e9;
+
+#if defined(__x86_64__)
+		case TIMER_TSC :
+			return __rdtsc() * timer.tscPeriod;
+#endif
+
+		default :
+			return MPI_Wtime();
+	}
+}
+
+/*
+ * Duree entre deux dates, sans le cout de la lecture de l'horloge qui s'y ajoute.
+ */
+double timerElapsed(double start, double stop) {
+	return stop - start - timer.overhead;
+}
+
+/*
+ * Cout d'une lecture de l'horloge : mediane des ecarts entre TIMER_CALIBRATION_READS lectures consecutives (la mediane ecarte
+ * les interruptions, et reste nulle pour une horloge plus grossiere que sa lecture).
+ */
+double timerCalibrate() {
+	float deltas[TIMER_CALIBRATION_READS - 1];
+	double last, now;
+	int i;
+
+	last = timerNow();
+
+	for(i = 0; i < TIMER_CALIBRATION_READS - 1; i++) {
+		now = timerNow();
+		deltas[i] = now - last;
+		last = now;
+	}
+
+	qsort(deltas, TIMER_CALIBRATION_READS - 1, sizeof(float), compareFloats);
+
+	return deltas[(TIMER_CALIBRATION_READS - 1) / 2];
+}
+
+/*
+ * Etalonnage du TSC : nombre de tics pendant TSC_CALIBRATION_TIME secondes de CLOCK_MONOTONIC_RAW. Renvoie la duree d'un tic.
+ */
+double tscCalibrate() {
+#if defined(__x86_64__)
+	struct timespec start, now;
+	unsigned long long ticks;
+	double elapsed;
+
+	clock_gettime(CLOCK_MONOTONIC_RAW, &start);
+	ticks = __rdtsc();
+
+	do {
+		clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+		elapsed = (now.tv_sec - start.tv_sec) + (now.tv_nsec - start.tv_nsec) / 1e9;
+	} while(elapsed < TSC_CALIBRATION_TIME);
+
+	return elapsed / (__rdtsc() - ticks);
+#else
+	return 0;
+#endif
+}
+
+/*
+ * TSC invariant (frequence constante, y compris dans les etats de veille du processeur) ? Bit 8 de EDX de la fonction
+ * 0x80000007 de cpuid.
+ */
+int tscInvariant() {
+#if defined(__x86_64__)
+	unsigned int eax, ebx, ecx, edx;
+
+	if(__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx))
+		return (edx >> 8) & 1;
+#endif
+
+	return 0;
+}
+
+char* timerName(int backend) {
+	char* names[3] = {"wtime", "raw", "tsc"};
+
+	return names[backend];
+}
+
+/*
+ * Description de l'horloge des mesures, pour l'affichage et les commentaires du YAML (chaine d'au moins 96 caracteres).
+ */
+void timerDescribe(char* str) {
+	sprintf(
+		str, "%s (resolution %.3f ns, read overhead %.3f ns subtracted)",
+		timerName(timerWorst.backend), timerWorst.resolution * 1e9, timerWorst.overhead * 1e9
+	);
+}
+
+/*
+ * Ecriture d'une taille en octets sous sa forme la plus courte (ex. 64K, 1M), dans une chaine d'au moins 16 caracteres.
+ */
+void formatSize(char* str, int size) {
+	if(size >= 1024*1024*1024 && size % (1024*1024*1024) == 0)
+		sprintf(str, "%dG", size / (1024*1024*1024));
+	else if(size >= 1024*1024 && size % (1024*1024) == 0)
+		sprintf(str, "%dM", size / (1024*1024));
+	else if(size >= 1024 && size % 1024 == 0)
+		sprintf(str, "%dK", size / 1024);
+	else
+		sprintf(str, "%d", size);
+}
+
+/*
+ * Creation d'un type BenchType pour MPI qui permettra de faire transiter des structures Bench d'un noeud a l'autre.
+ */
+void createBenchType() {
+	MPI_Type_extent(MPI_INT, &extentType);
+
+	/* Les deux ranks, puis tous les champs flottants a la suite */
+	benchTypeDisp[0] = 0;
+	benchTypeDisp[1] = extentType*2;
+
+	MPI_Type_struct(2, benchTypeBlocks, benchTypeDisp, benchTypeTypes, &BenchType);
+	MPI_Type_commit(&BenchType);
+}
+
+/*
+ * Creation d'un type TestType pour MPI qui permettra de faire transiter des structures YourTest d'un noeud a l'autre.
+ */
+void createTestType() {
+	MPI_Type_extent(MPI_INT, &extentType);
+
+	testTypeDisp[0] = 0;
+	testTypeDisp[1] = extentType;
+
+	MPI_Type_struct(2, testTypeBlocks, testTypeDisp, testTypeTypes, &TestType);
+	MPI_Type_commit(&TestType);
+}
+
+/*
+ * Met en ecoute tous les autres noeuds que l'envoyeur designe, afin qu'ils soient prets a recevoir un test de celui-ci.
+ */
+void prepareTests(Topology* topo, int i, Options* o) {
+	int sender = topo->players[i], recver, k;
+
+	for(k = 0; k < topoNbRecvers(topo, o); k++) {
+		recver = topoRecver(topo, i, k, o);
+
+		if(linkSelected(topo, sender, recver, o))
+			prepareTest(sender, recver);
+	}
+}
+
+/*
+ * Envoi de son test de receveur a un seul noeud.
+ */
+void prepareTest(int sender, int recver) {
+	YourTest t;
+
+	t.role = RECVER;
+	t.withRank = sender;
+
+	MPI_Send(&t, 1, TestType, recver, 0, MPI_COMM_WORLD);
+}
+
+/*
+ * Envoi de son test a l'envoyeur pour lui indiquer de communiquer avec un des receveurs pret a receptionner un mot
+ * de lui.
+ */
+void launchTests(int sender, int recver) {
+	YourTest t;
+
+	t.role = SENDER;
+	t.withRank = recver;
+
+	MPI_Send(&t, 1, TestType, sender, 0, MPI_COMM_WORLD);
+}
+
+/*
+ * Par defaut, tous les noeuds attendent un test du MASTER.
+ */
+void waitTests(YourTest* t) {
+	MPI_Recv(t, 1, TestType, MASTER, 0, MPI_COMM_WORLD, &status);
+}
+
+/*
+ * Envoi du resultat au MASTER, de la part de l'envoyeur.
+ */
+void sendResults(Bench* r) {
+	MPI_Send(r, 1, BenchType, MASTER, 0, MPI_COMM_WORLD);
+}
+
+/*
+ * Reception du resultat de l'envoyeur qui vient de realiser son test avec le receveur (pour le rank 0), jusqu'a la date limite
+ * (0 pour attendre sans limite, voir timedWait). Le resultat en retard d'un test deja abandonne est ignore, avec sa courbe du
+ * balayage. Renvoie 0 si l'envoyeur n'a pas repondu a temps : le lien est alors note hors delai, sans repetition conservee.
+ */
+int receiveResults(Bench* r, int sender, int recver, double deadline, Options* o) {
+	MPI_Request req;
+	YourTest t;
+	float* stale;
+
+	do {
+		MPI_Irecv(r, 1, BenchType, sender, 0, MPI_COMM_WORLD, &req);
+
+		if(!timedWait(&req, deadline)) {
+			t.withRank = recver;
+			formatTestsResult(r, &t, sender);
+			r->samples = 0;
+			r->timedOut = 1;
+
+			return 0;
+		}
+
+		if(r->recver != recver && o->nbSizes > 0) {
+			stale = (float*) malloc(sizeof(float) * 2 * o->nbSizes);
+
+			if(stale == NULL) {
+				fprintf(stderr, "ERROR: Can't allocate memory.");
+				exit(1);
+			}
+
+			receiveSweep(stale, sender, o);
+			free(stale);
+		}
+	} while(r->recver != recver);
+
+	return 1;
+}
+
+/* Formatage du Bench qui sera renvoye au MASTER */
+void formatTestsResult(Bench* r, YourTest* t, int rank) {
+	size_t field;
+
+	/* Les deux joueurs sont renseignes, et la latence est mise a -1 : si le test n'est
+	jamais utilise, la latence restera ainsi, et pourra alors etre un indicateur de la non
+	pertinence du resultat. */
+	r->sender = rank;
+	r->recver = t->withRank;
+
+	for(field = offsetof(Bench, latency); field < sizeof(Bench); field += sizeof(float))
+		BENCH_FIELD(r, field) = -1;
+}
+
+/*
+ * Table des hostnames de tous les ranks, echangee une seule fois entre tous les noeuds : HOSTNAME_SIZE caracteres par rank,
+ * le nom du rank i commencant a i*HOSTNAME_SIZE (voir rankToHostname).
+ */
+char* createHostnames(int nbNodes) {
+	char hostname[MPI_MAX_PROCESSOR_NAME], *hostnames, *sep;
+	int sizeHostname;
+
+	hostnames = (char*) malloc(nbNodes * HOSTNAME_SIZE);
+
+	if(hostnames == NULL) {
+		fprintf(stderr, "ERROR: Can't allocate memory.");
+		exit(1);
+	}
+
+	/* Renseignement du nom du noeud courant */
+	MPI_Get_processor_name(hostname, &sizeHostname);
+
+	/* Reduction du nom du noeud a sa premiere partie (ex. on vire .site.grid5000.fr), si
+	celui-ci semble renvoyer un FQDN (presence d'au moins un point) en guise de hostname */
+	if((sep = strchr(hostname, '.')) != NULL)
+		*sep = '\0';
+
+	hostname[HOSTNAME_SIZE-1] = '\0';
+
+	MPI_Allgather(hostname, HOSTNAME_SIZE, MPI_CHAR, hostnames, HOSTNAME_SIZE, MPI_CHAR, MPI_COMM_WORLD);
+
+	return hostnames;
+}
+
+/*
+ * Regroupement des ranks par machine : les ranks qui partagent la memoire (MPI_COMM_TYPE_SHARED) sont sur la meme machine, dont
+ * le leader est le plus petit rank hors MASTER. Chaque noeud connait ensuite la machine de tous les ranks, et la liste des ranks
+ * testes : tous, ou seulement les leaders avec l'option -t leaders. Le MASTER est toujours en tete de cette liste, pour qu'elle
+ * remplace directement les ranks dans les fonctions de preparation des tests (voir topoMapTests).
+ */
+void createTopology(Topology* t, int nbNodes, Options* o) {
+	MPI_Comm nodeComm;
+	int rank, me, leader, i;
+
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+	t->nodeOf = (int*) malloc(sizeof(int) * nbNodes);
+	t->players = (int*) malloc(sizeof(int) * nbNodes);
+
+	if(t->nodeOf == NULL || t->players == NULL) {
+		fprintf(stderr, "ERROR: Can't allocate memory.");
+		exit(1);
+	}
+
+	MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &nodeComm);
+
+	me = (rank == MASTER) ? nbNodes : rank;
+	MPI_Allreduce(&me, &leader, 1, MPI_INT, MPI_MIN, nodeComm);
+	MPI_Comm_free(&nodeComm);
+
+	/* Le MASTER seul sur sa machine est son propre leader */
+	if(leader == nbNodes)
+		leader = MASTER;
+
+	MPI_Allgather(&leader, 1, MPI_INT, t->nodeOf, 1, MPI_INT, MPI_COMM_WORLD);
+
+	t->players[0] = MASTER;
+	t->nbPlayers = 1;
+	t->nbHosts = 0;
+
+	for(i = 1; i < nbNodes; i++) {
+		if(t->nodeOf[i] == i)
+			t->nbHosts++;
+
+		if(o->topology != TOPO_LEADERS || t->nodeOf[i] == i)
+			t->players[t->nbPlayers++] = i;
+	}
+}
+
+/*
+ * Le lien de l'envoyeur vers le receveur est il de la classe demandee (tous, internes a une machine ou entre machines) ?
+ */
+int linkInClass(int* nodeOf, int sender, int recver, int linkClass) {
+	if(linkClass == TOPO_INTRA)
+		return nodeOf[sender] == nodeOf[recver];
+
+	if(linkClass == TOPO_INTER)
+		return nodeOf[sender] != nodeOf[recver];
+
+	return 1;
+}
+
+/*
+ * Le lien entre deux ranks testes doit il etre teste, selon l'option -t ?
+ */
+int linkSelected(Topology* t, int sender, int recver, Options* o) {
+	return sender != recver && linkInClass(t->nodeOf, sender, recver, o->topology);
+}
+
+/*
+ * Passage des tests prepares sur les indices de la liste des ranks testes (bissection, tours de la matrice concurrente) aux
+ * tests des ranks eux memes. Les ranks non testes sont desactives, ainsi que les paires dont le lien n'est pas retenu.
+ */
+void topoMapTests(YourTest* bissTests, Topology* t, Options* o) {
+	YourTest* tests = (YourTest*) malloc(sizeof(YourTest) * t->nbPlayers);
+	int i, nbNodes;
+
+	if(tests == NULL) {
+		fprintf(stderr, "ERROR: Can't allocate memory.");
+		exit(1);
+	}
+
+	MPI_Comm_size(MPI_COMM_WORLD, &nbNodes);
+	memcpy(tests, bissTests, sizeof(YourTest) * t->nbPlayers);
+
+	for(i = 0; i < nbNodes; i++) {
+		bissTests[i].role = DEACTIVATED;
+		bissTests[i].withRank = -1;
+	}
+
+	for(i = 1; i < t->nbPlayers; i++) {
+		if(tests[i].role == DEACTIVATED)
+			continue;
+
+		bissTests[t->players[i]].role = tests[i].role;
+		bissTests[t->players[i]].withRank = t->players[tests[i].withRank];
+	}
+
+	/* Les deux joueurs d'une paire ecartee sont desactives */
+	for(i = 1; i < nbNodes; i++) {
+		if(bissTests[i].role == SENDER && !linkSelected(t, i, bissTests[i].withRank, o)) {
+			bissTests[bissTests[i].withRank].role = DEACTIVATED;
+			bissTests[bissTests[i].withRank].withRank = -1;
+			bissTests[i].role = DEACTIVATED;
+			bissTests[i].withRank = -1;
+		}
+	}
+
+	free(tests);
+}
+
+/*
+ * Nombre de tests que recevra un noeud : un seul en bissection, un par tour en matrice concurrente, et en matrice classique
+ * un par lien retenu dont il est l'envoyeur ou le receveur (en mode echantillonne, vers ses partenaires et depuis les ranks
+ * dont il est le partenaire).
+ */
+int topoNbTests(Topology* t, int rank, Options* o) {
+	int i, k, nb = 0;
+
+	if(o->bissection)
+		return 1;
+
+	if(o->concurrent)
+		return topoNbRounds(t, o);
+
+	/* Les ranks non testes (option -t leaders) ne recoivent aucun test */
+	if(o->topology == TOPO_LEADERS && t->nodeOf[rank] != rank)
+		return 0;
+
+	if(o->sampled) {
+		for(i = 1; t->players[i] != rank; i++);
+
+		for(k = 0; k < o->sampled; k++) {
+			nb += linkSelected(t, rank, topoRecver(t, i, k, o), o);
+			nb += linkSelected(t, t->players[samplePartner(i, t->nbPlayers - 1 - o->shifts[k], t->nbPlayers)], rank, o);
+		}
+
+		return nb;
+	}
+
+	for(i = 1; i < t->nbPlayers; i++)
+		nb += linkSelected(t, rank, t->players[i], o) + linkSelected(t, t->players[i], rank, o);
+
+	return nb;
+}
+
+/*
+ * Nombre de tours de la matrice concurrente : ceux du tournoi round-robin, ou SAMPLE_ROUNDS par decalage en mode echantillonne.
+ */
+int topoNbRounds(Topology* t, Options* o) {
+	return o->sampled ? SAMPLE_ROUNDS * o->sampled : rrNbRounds(t->nbPlayers);
+}
+
+/*
+ * Nombre de receveurs de chaque envoyeur en matrice classique (tous les autres ranks testes, ou ses partenaires en mode
+ * echantillonne), et rank du k-ieme receveur de l'envoyeur d'indice i dans la liste des ranks testes.
+ */
+int topoNbRecvers(Topology* t, Options* o) {
+	return o->sampled ? o->sampled : t->nbPlayers - 1;
+}
+
+int topoRecver(Topology* t, int i, int k, Options* o) {
+	return t->players[o->sampled ? samplePartner(i, o->shifts[k], t->nbPlayers) : k + 1];
+}
+
+/*
+ * Affichage du regroupement des ranks testes par machine, avant les statistiques par classe de liens.
+ */
+void displayTopology(Topology* t) {
+	printf("\nTopology : %d tested ranks on %d hosts\n", t->nbPlayers - 1, t->nbHosts);
+}
+
+/*
+ * Initialisation des matrices des resultats (une par champ flottant des Bench), a -1 pour reperer les paires non testees. Les
+ * champs qui ne serviront pas avec les options choisies ne sont pas alloues.
+ */
+void initResults(Results* r, int nbNodes, char* hostnames, Topology* t, Options* o) {
+	size_t field, size, j;
+	float* values;
+	int i, k;
+
+	r->nbNodes = nbNodes;
+	r->hostnames = hostnames;
+	r->nodeOf = t->nodeOf;
+	r->nbPartners = o->sampled;
+	r->partners = NULL;
+
+	/* Mode echantillonne : les partenaires de chaque envoyeur, dans l'ordre des decalages */
+	if(o->sampled) {
+		r->partners = (int*) malloc(sizeof(int) * nbNodes * o->sampled);
+
+		if(r->partners == NULL) {
+			fprintf(stderr, "ERROR: Can't allocate memory.");
+			exit(1);
+		}
+
+		for(i = 0; i < nbNodes * o->sampled; r->partners[i++] = -1);
+
+		for(i = 1; i < t->nbPlayers; i++) {
+			for(k = 0; k < o->sampled; k++)
+				r->partners[t->players[i] * o->sampled + k] = topoRecver(t, i, k, o);
+		}
+	}
+
+	size = o->sampled ? (size_t) nbNodes * o->sampled + 1 : (size_t) nbNodes * nbNodes;
+
+	for(field = offsetof(Bench, latency); field < sizeof(Bench); field += sizeof(float)) {
+		values = NULL;
+
+		if(resultsFieldUsed(field, o)) {
+			values = (float*) malloc(sizeof(float) * size);
+
+			if(values == NULL) {
+				fprintf(stderr, "ERROR: Can't allocate memory.");
+				exit(1);
+			}
+
+			for(j = 0; j < size; values[j++] = -1);
+		}
+
+		r->fields[BENCH_INDEX(field)] = values;
+	}
+
+	r->binFile = NULL;
+	r->clocks = NULL;
+
+	if(o->bin)
+		r->binFile = createResultsFile(o->binFile, nbNodes, hostnames, o);
+}
+
+/*
+ * Creation du fichier binaire des resultats (option -B) : l'entete reprend les parametres du test, les resultats seront ajoutes
+ * a leur arrivee par storeResult.
+ */
+FILE* createResultsFile(char* binFile, int nbNodes, char* hostnames, Options* o) {
+	ResultsFileHeader h;
+	FILE* f;
+
+	h.nbNodes = nbNodes;
+	h.flags = (o->bissection ? RESULTS_FILE_BISSECTION : 0) | (o->concurrent ? RESULTS_FILE_CONCURRENT : 0)
+		| (o->distributed ? RESULTS_FILE_DISTRIBUTED : 0) | (o->sampled ? RESULTS_FILE_SAMPLED : 0);
+	h.pktSize = o->pktSize;
+	h.nbRetry = o->nbRetry;
+	h.window = o->window;
+	h.nbWindows = o->nbWindows;
+	h.seed = o->seed;
+	h.bufferPolicy = o->bufferPolicy;
+	h.coldSize = o->coldSize;
+	h.rmaSync = o->rma;
+
+	f = resultsFileCreate(binFile, &h, hostnames);
+
+	if(f == NULL) {
+		fprintf(stderr, "ERROR: Can't write the results file.");
+		exit(1);
+	}
+
+	return f;
+}
+
+/*
+ * Un champ des Bench sert il avec les options choisies ? La latence et le debit toujours, le reste selon les tests actifs et
+ * les sorties demandees (le resume des distributions n'apparait que dans le YAML).
+ */
+int resultsFieldUsed(size_t field, Options* o) {
+	if(field == offsetof(Bench, streamFlow))
+		return o->window > 0;
+
+	if(field >= offsetof(Bench, bidirFlow) && field <= offsetof(Bench, bidirIn))
+		return o->bidir;
+
+	if(field == offsetof(Bench, samples))
+		return o->target > 0 || o->yaml || o->compare || o->timeout > 0;
+
+	if(field == offsetof(Bench, verifiedFlow) || field == offsetof(Bench, corrupted))
+		return o->integrity;
+
+	if(field >= offsetof(Bench, putLatency) && field <= offsetof(Bench, getFlow))
+		return o->rma != RMA_NONE;
+
+	if(field >= offsetof(Bench, oneWayOut) && field <= offsetof(Bench, oneWayAt))
+		return o->oneWay;
+
+	if(field == offsetof(Bench, timedOut))
+		return o->timeout > 0;
+
+	if(field >= offsetof(Bench, latencyMin))
+		return o->yaml || o->compare;
+
+	return 1;
+}
+
+/*
+ * Rangement d'un resultat dans les matrices, a la place de la paire envoyeur/receveur.
+ */
+void storeResult(Results* r, Bench* b) {
+	size_t field;
+
+	for(field = offsetof(Bench, latency); field < sizeof(Bench); field += sizeof(float)) {
+		if(r->fields[BENCH_INDEX(field)] != NULL)
+			RESULT(r, field, b->sender, b->recver) = BENCH_FIELD(b, field);
+	}
+
+	/* Enregistrement complet (distributions comprises) dans le fichier binaire, sans attendre la fin des tests */
+	if(r->binFile != NULL)
+		resultsFileAppend(r->binFile, b);
+}
+
+/*
+ * Rangement des resultats des envoyeurs d'une bissection ou d'un tour (ceux dont la latence n'est pas restee a -1).
+ */
+void storeAllResults(Results* r, Bench* bissResults) {
+	int i;
+
+	for(i = 1; i < r->nbNodes; i++) {
+		if(bissResults[i].latency != -1 || bissResults[i].timedOut == 1)
+			storeResult(r, &bissResults[i]);
+	}
+}
+
+/*
+ * Reconstitution du Bench d'une paire a partir des matrices (les champs non alloues valent -1).
+ */
+void loadResult(Results* r, int sender, int recver, Bench* b) {
+	size_t field;
+
+	b->sender = sender;
+	b->recver = recver;
+
+	for(field = offsetof(Bench, latency); field < sizeof(Bench); field += sizeof(float))
+		BENCH_FIELD(b, field) = (r->fields[BENCH_INDEX(field)] != NULL) ? RESULT(r, field, sender, recver) : -1;
+}
+
+/*
+ * La paire a t elle ete testee ? (hors diagonale, et latence differente de -1)
+ */
+int resultTested(Results* r, int sender, int recver) {
+	return sender != recver && RESULT(r, offsetof(Bench, latency), sender, recver) != -1;
+}
+
+/*
+ * Indice d'une paire dans les matrices des resultats. En mode echantillonne, la paire est cherchee parmi les partenaires de
+ * l'envoyeur ; hors echantillon, c'est la derniere valeur, toujours a -1 (non testee).
+ */
+int resultIndex(Results* r, int sender, int recver) {
+	int k;
+
+	if(r->nbPartners == 0)
+		return sender * r->nbNodes + recver;
+
+	for(k = 0; k < r->nbPartners; k++) {
+		if(r->partners[sender * r->nbPartners + k] == recver)
+			return sender * r->nbPartners + k;
+	}
+
+	return r->nbNodes * r->nbPartners;
+}
+
+/*
+ * Parcours des receveurs possibles d'un envoyeur : tous les ranks, ou ses seuls partenaires en mode echantillonne (le k-ieme
+ * receveur d'un envoyeur, a tester avec resultTested).
+ */
+int resultNbRecvers(Results* r) {
+	return r->nbPartners ? r->nbPartners : r->nbNodes;
+}
+
+int resultRecver(Results* r, int sender, int k) {
+	return r->nbPartners ? r->partners[sender * r->nbPartners + k] : k;
+}
+
+/*
+ * Tests de debit/latence de l'envoyeur vers le receveur.
+ */
+int benchTests(YourTest* t, Bench* r, float* series, Options* o) {
+	double start, stop;
+	int pktSize = o->pktSize;
+
+	/* En mode cold, chaque repetition utilise un autre emplacement de la reserve */
+	bufferNext();
+
+	/* Un mot vide (4 octets) est envoye au receveur, qui repondra immediatement un mot de la meme nature.
+	Le temps est compte, de l'envoi du mot au receveur jusqu'a la reception de sa reponse. */
+	start = timerNow();
+
+	if(!timedSend(buffer, 0, t->withRank) || !timedRecv(buffer, 0, t->withRank))
+		return 0;
+
+	stop = timerNow();
+
+	/* La latence est calculee en fonction du temps mis par le mot pour arriver au destinataire (division par 2
+	pour eliminer le tps de reponse qui est cense etre identique.
+	Passage de seconde a microseconde en multiplisant par un million. */
+	r->latency = (timerElapsed(start, stop) / 2) * 1e6;
+
+	/* Un mot plus ou moins consequent (option -s) est envoye au receveur. Celui-ci renvoyant un mot vide.
+	Le temps est egalement compte, de l'envoi jusqu'a la reception. */
+	start = timerNow();
+
+	if(!timedSend(buffer, pktSize, t->withRank) || !timedRecv(buffer, 0, t->withRank))
+		return 0;
+
+	stop = timerNow();
+
+	/* La difference de temps est prise en compte. On lui soustraie deux fois la latence - en seconde grace a la
+	division - d'un mot vide (soit le tps que met le tuyau a faire transiter les donnees, quelque soit la taille des
+	donnees). Enfin, on divise le nombre d'octets qui ont transites avec ce resultat. On divise le tout par 1024 au
+	carre pour avoir des Mo/s au lieu de o/s. Cette facon de proceder releve de l'approche NWS : http://nws.cs.ucsb.ed */
+	r->flow = pktSize / (timerElapsed(start, stop) - (2*r->latency/1e6)) / pow(1024, 2);
+
+	/* Debit en flux continu, si il est actif */
+	r->streamFlow = -1;
+
+	if(o->window > 0)
+		streamTests(t, r, o);
+
+	/* Debits dans les deux sens a la fois, si le mode bidirectionnel est actif */
+	r->bidirFlow = r->bidirOut = r->bidirIn = -1;
+
+	if(o->bidir)
+		bidirTests(t, r, o);
+
+	/* Debit avec verification du contenu, si le mode integrite est actif */
+	r->verifiedFlow = r->corrupted = -1;
+
+	if(o->integrity)
+		integrityTests(t, r, o);
+
+	/* Latences et debits des operations RMA, si elles sont testees */
+	r->putLatency = r->putFlow = r->getLatency = r->getFlow = -1;
+
+	if(o->rma != RMA_NONE)
+		rmaTests(t, r, o);
+
+	/* Latence dans chaque sens, si les horloges ont ete comparees */
+	r->oneWayOut = r->oneWayIn = r->oneWayAt = -1;
+
+	if(o->oneWay)
+		oneWayTests(t, r);
+
+	/* Balayage des tailles de messages, si il est actif */
+	if(o->nbSizes > 0)
+		sweepTests(t, series, o);
+
+	return 1;
+}
+
+/*
+ * Reponses automatiques aux envoi du noeud qui joue le role d'envoyeur. Renvoie 0 si le ping-pong a depasse le delai du test.
+ */
+int responsesToTests(YourTest* t, Options* o) {
+	bufferNext();
+
+	if(!timedRecv(buffer, 0, t->withRank) || !timedSend(buffer, 0, t->withRank))
+		return 0;
+
+	if(!timedRecv(buffer, o->pktSize, t->withRank) || !timedSend(buffer, 0, t->withRank))
+		return 0;
+
+	if(o->window > 0)
+		responsesToStream(t, o);
+
+	if(o->bidir)
+		responsesToBidir(t, o);
+
+	if(o->integrity)
+		responsesToIntegrity(t, o);
+
+	if(o->rma != RMA_NONE)
+		responsesToRma(t, o);
+
+	if(o->oneWay)
+		responsesToOneWay(t);
+
+	if(o->nbSizes > 0)
+		responsesToSweep(t, o);
+
+	return 1;
+}
+
+/*
+ * Debut d'un test avec un delai (option -e) : date limite du test, toutes repetitions comprises, et etiquette propre a ce test
+ * de la paire. Les messages en retard d'un test abandonne ne sont ainsi jamais pris pour ceux d'un test suivant.
+ */
+void testStart(YourTest* t, Options* o) {
+	if(o->timeout <= 0 || t->role == DEACTIVATED)
+		return;
+
+	testDeadline = MPI_Wtime() + o->timeout;
+	testTag = TIMEOUT_TAG_BASE + pairTests[t->withRank]++ % TIMEOUT_TAGS;
+}
+
+/*
+ * Attente d'une communication non bloquante jusqu'a la date limite, ou sans limite si elle vaut 0. Une communication inachevee
+ * a temps est annulee puis abandonnee a la bibliotheque MPI. Renvoie 0 si la date limite est depassee.
+ */
+int timedWait(MPI_Request* req, double deadline) {
+	int done = 0;
+
+	if(deadline <= 0) {
+		MPI_Wait(req, &status);
+		return 1;
+	}
+
+	while(!done) {
+		MPI_Test(req, &done, &status);
+
+		if(!done && MPI_Wtime() > deadline) {
+			MPI_Cancel(req);
+			MPI_Request_free(req);
+
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+/*
+ * Envoi et reception d'un message du ping-pong au partenaire du test. Sans delai, ce sont les simples communications bloquantes
+ * des mesures ; avec un delai, elles sont non bloquantes et attendues jusqu'a la date limite du test (voir testStart).
+ */
+int timedSend(void* buf, int size, int peer) {
+	MPI_Request req;
+
+	if(testDeadline <= 0) {
+		MPI_Send(buf, size, MPI_BYTE, peer, testTag, MPI_COMM_WORLD);
+		return 1;
+	}
+
+	MPI_Isend(buf, size, MPI_BYTE, peer, testTag, MPI_COMM_WORLD, &req);
+
+	return timedWait(&req, testDeadline);
+}
+
+int timedRecv(void* buf, int size, int peer) {
+	MPI_Request req;
+
+	if(testDeadline <= 0) {
+		MPI_Recv(buf, size, MPI_BYTE, peer, testTag, MPI_COMM_WORLD, &status);
+		return 1;
+	}
+
+	MPI_Irecv(buf, size, MPI_BYTE, peer, testTag, MPI_COMM_WORLD, &req);
+
+	return timedWait(&req, testDeadline);
+}
+
+/*
+ * Decision, pour l'envoyeur qui a deja fait i repetitions d'un test (echauffement compris), d'en faire une de plus : les nbRetry
+ * premieres sont toujours faites, puis en mode adaptatif le test continue jusqu'a ce que les medianes aient converge ou que
+ * maxRetry repetitions soient atteintes.
+ */
+int moreTests(Bench* sameBenchs, int i, Options* o) {
+	int n = i - o->warmup;
+
+	if(n < o->nbRetry)
+		return 1;
+
+	if(o->target <= 0 || n >= o->maxRetry)
+		return 0;
+
+	return !benchsConverged(sameBenchs, n, o);
+}
+
+/*
+ * Decision commune, pour tous les joueurs d'un test, de faire une repetition de plus (la i+1 ieme). Avec un nombre fixe de
+ * repetitions, chacun la connait. En mode adaptatif, l'envoyeur transmet sa decision (more) a son receveur ; si les tests sont
+ * synchronises (bissection, matrice concurrente), tous les noeuds continuent ensemble tant qu'un envoyeur en demande plus.
+ */
+int nextTest(YourTest* t, int i, int more, Options* o) {
+	MPI_Request req;
+	int all;
+
+	if(o->target <= 0)
+		return i < o->warmup + o->nbRetry;
+
+	if(o->bissection || o->concurrent) {
+		MPI_Allreduce(&more, &all, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+		return all;
+	}
+
+	/* Avec un delai (option -e), la decision a sa propre etiquette, tiree avec celle du test, et le receveur ne l'attend que
+	jusqu'a la date limite */
+	if(testDeadline > 0) {
+		if(t->role == SENDER)
+			MPI_Isend(&more, 1, MPI_INT, t->withRank, testTag + TIMEOUT_TAGS, MPI_COMM_WORLD, &req);
+		else
+			MPI_Irecv(&more, 1, MPI_INT, t->withRank, testTag + TIMEOUT_TAGS, MPI_COMM_WORLD, &req);
+
+		return timedWait(&req, testDeadline) && more;
+	}
+
+	if(t->role == SENDER)
+		MPI_Send(&more, 1, MPI_INT, t->withRank, 5, MPI_COMM_WORLD);
+	else
+		MPI_Recv(&more, 1, MPI_INT, t->withRank, 5, MPI_COMM_WORLD, &status);
+
+	return more;
+}
+
+/*
+ * Comparaison de deux flottants, pour qsort.
+ */
+int compareFloats(const void* a, const void* b) {
+	float x = *(const float*) a, y = *(const float*) b;
+
+	return (x > y) - (x < y);
+}
+
+/*
+ * Convergence des n repetitions d'un test : l'intervalle de confiance a 95% des medianes de la latence et du debit doit avoir
+ * une demi-largeur d'au plus target pourcents de la mediane. L'intervalle est pris entre les echantillons tries de rangs
+ * n/2 -+ 1.96*sqrt(n)/2, sans hypothese sur la distribution des mesures.
+ */
+int benchsConverged(Bench* sameBenchs, int n, Options* o) {
+	size_t fields[2] = { offsetof(Bench, latency), offsetof(Bench, flow) };
+	float *values, median;
+	int f, i, lo, hi, ok = 1;
+
+	lo = (int) floor(n / 2.0 - 1.96 * sqrt(n) / 2);
+	hi = (int) ceil(n / 2.0 + 1.96 * sqrt(n) / 2);
+
+	/* Pas assez de repetitions pour encadrer la mediane */
+	if(lo < 1 || hi > n)
+		return 0;
+
+	values = (float*) malloc(sizeof(float) * n);
+
+	if(values == NULL) {
+		fprintf(stderr, "ERROR: Can't allocate memory.");
+		exit(1);
+	}
+
+	for(f = 0; f < 2 && ok; f++) {
+		for(i = 0; i < n; i++)
+			values[i] = BENCH_FIELD(&sameBenchs[i], fields[f]);
+
+		qsort(values, n, sizeof(float), compareFloats);
+		median = sortedMedian(values, n);
+
+		/* Rangs lo et hi a partir de 1 */
+		ok = (values[hi-1] - values[lo-1]) / 2 <= fabs(median) * o->target / 100;
+	}
+
+	free(values);
+
+	return ok;
+}
+
+/*
+ * Mediane exacte de n valeurs deja triees (moyenne des deux valeurs du milieu si n est pair).
+ */
+float sortedMedian(float* values, int n) {
+	return (n % 2) ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+}
+
+/*
+ * Mediane exacte d'un champ des n repetitions d'un test.
+ */
+float benchsMedian(Bench* sameBenchs, int n, size_t field) {
+	float *values, median;
+	int i;
+
+	values = (float*) malloc(sizeof(float) * n);
+
+	if(values == NULL) {
+		fprintf(stderr, "ERROR: Can't allocate memory.");
+		exit(1);
+	}
+
+	for(i = 0; i < n; i++)
+		values[i] = BENCH_FIELD(&sameBenchs[i], field);
+
+	qsort(values, n, sizeof(float), compareFloats);
+	median = sortedMedian(values, n);
+	free(values);
+
+	return median;
+}
+
+/*
+ * Test de debit en flux continu (option -w), de l'envoyeur vers le receveur. Une fenetre de o->window envois non bloquants
+ * de pktSize octets est maintenue en vol, et le receveur n'acquitte qu'une fois par fenetre : contrairement a l'approche NWS
+ * (un mot, un acquittement), le tuyau reste plein et le debit mesure est le debit soutenu du lien.
+ */
+void streamTests(YourTest* t, Bench* r, Options* o) {
+	double start, stop;
+	int w, j;
+	MPI_Request* requests;
+
+	requests = (MPI_Request*) malloc(sizeof(MPI_Request) * o->window);
+
+	if(requests == NULL) {
+		fprintf(stderr, "ERROR: Can't allocate memory.");
+		exit(1);
+	}
+
+	start = timerNow();
+
+	for(w = 0; w < o->nbWindows; w++) {
+
+		/* Tous les mots de la fenetre partent du meme buffer, qui n'est que lu */
+		for(j = 0; j < o->window; j++)
+			MPI_Isend(buffer, o->pktSize, MPI_BYTE, t->withRank, 2, MPI_COMM_WORLD, &requests[j]);
+
+		MPI_Waitall(o->window, requests, MPI_STATUSES_IGNORE);
+
+		/* Acquittement de la fenetre par le receveur */
+		MPI_Recv(buffer, 0, MPI_BYTE, t->withRank, 2, MPI_COMM_WORLD, &status);
+	}
+
+	stop = timerNow();
+
+	/* Octets transmis sur la duree totale, en Mo/s */
+	r->streamFlow = ((double) o->pktSize * o->window * o->nbWindows) / timerElapsed(start, stop) / pow(1024, 2);
+
+	free(requests);
+}
+
+/*
+ * Test de debit bidirectionnel (option -d) : l'envoyeur et le receveur s'envoient chacun pktSize octets au meme moment, avec
+ * des envois et receptions non bloquants, comme dans un echange de halo. Les deux sens sont mesures sur l'horloge de
+ * l'envoyeur, depuis un meme depart pris avant le mot vide qui lance le receveur : le sens receveur -> envoyeur jusqu'a sa
+ * reception, le sens envoyeur -> receveur jusqu'a l'acquittement de la reception du receveur. Chacun compte ainsi au plus
+ * une latence de trop, ce qui est negligeable devant le temps de transfert de pktSize octets. Le debit agrege est la somme
+ * des debits des deux sens.
+ */
+void bidirTests(YourTest* t, Bench* r, Options* o) {
+	double start, in = 0, out = 0;
+	MPI_Request requests[3];
+	int k, done;
+
+	/* Receptions postees avant le depart : le mot du receveur dans la seconde moitie du buffer, et son acquittement. Les mots
+	de synchro ont leur propre tag, afin de ne pas etre pris par la reception du mot. */
+	MPI_Irecv((char*) buffer + o->pktSize, o->pktSize, MPI_BYTE, t->withRank, 3, MPI_COMM_WORLD, &requests[0]);
+	MPI_Irecv(buffer, 0, MPI_BYTE, t->withRank, 4, MPI_COMM_WORLD, &requests[1]);
+
+	start = timerNow();
+	MPI_Send(buffer, 0, MPI_BYTE, t->withRank, 4, MPI_COMM_WORLD);
+	MPI_Isend(buffer, o->pktSize, MPI_BYTE, t->withRank, 3, MPI_COMM_WORLD, &requests[2]);
+
+	/* Temps de chaque sens, dans l'ordre ou ils se terminent */
+	for(k = 0; k < 2; k++) {
+		MPI_Waitany(2, requests, &done, MPI_STATUS_IGNORE);
+
+		if(done == 0)
+			in = timerElapsed(start, timerNow());
+		else
+			out = timerElapsed(start, timerNow());
+	}
+
+	MPI_Wait(&requests[2], MPI_STATUS_IGNORE);
+
+	r->bidirOut = o->pktSize / out / pow(1024, 2);
+	r->bidirIn = o->pktSize / in / pow(1024, 2);
+	r->bidirFlow = r->bidirOut + r->bidirIn;
+}
+
+/*
+ * Test d'integrite (option -i), de l'envoyeur vers le receveur : un mot de pktSize octets rempli d'un motif pseudo aleatoire,
+ * termine par son CRC32C, est envoye comme pour le test de debit, mais le receveur ne l'acquitte qu'apres l'avoir verifie. Le
+ * remplissage se fait avant le chronometre, la verification est comprise dans le debit verifie.
+ */
+void integrityTests(YourTest* t, Bench* r, Options* o) {
+	double start, stop;
+	int ok;
+
+	integrityFill((char*) buffer, o->pktSize, ((unsigned long long) t->withRank << 32) ^ integritySeq++);
+
+	start = timerNow();
+	MPI_Send(buffer, o->pktSize, MPI_BYTE, t->withRank, 7, MPI_COMM_WORLD);
+	MPI_Recv(&ok, 1, MPI_INT, t->withRank, 7, MPI_COMM_WORLD, &status);
+	stop = timerNow();
+
+	/* Meme calcul que le debit NWS */
+	r->verifiedFlow = o->pktSize / (timerElapsed(start, stop) - (2*r->latency/1e6)) / pow(1024, 2);
+	r->corrupted = !ok;
+}
+
+/*
+ * Reponses automatiques au test d'integrite : verification du CRC32C du mot recu, et acquittement avec le resultat.
+ */
+void responsesToIntegrity(YourTest* t, Options* o) {
+	unsigned int crc;
+	int ok;
+
+	MPI_Recv(buffer, o->pktSize, MPI_BYTE, t->withRank, 7, MPI_COMM_WORLD, &status);
+
+	memcpy(&crc, (char*) buffer + o->pktSize - sizeof(crc), sizeof(crc));
+	ok = crc32c(buffer, o->pktSize - sizeof(crc)) == crc;
+
+	MPI_Send(&ok, 1, MPI_INT, t->withRank, 7, MPI_COMM_WORLD);
+}
+
+/*
+ * Tests RMA (option -x), l'envoyeur etant l'origine et le receveur la cible : latence (un entier) et debit (pktSize octets) de
+ * MPI_Put puis de MPI_Get, chacun dans une epoque de la synchronisation choisie. La fenetre est propre a la paire (voir rmaOpen).
+ */
+void rmaTests(YourTest* t, Bench* r, Options* o) {
+	RmaPair p;
+
+	rmaOpen(t, &p, o);
+
+	r->putLatency = rmaEpoch(&p, RMA_PUT, sizeof(int), 1, o) / 2 * 1e6;
+	r->putFlow = o->pktSize / rmaEpoch(&p, RMA_PUT, o->pktSize, 1, o) / pow(1024, 2);
+	r->getLatency = rmaEpoch(&p, RMA_GET, sizeof(int), 1, o) / 2 * 1e6;
+	r->getFlow = o->pktSize / rmaEpoch(&p, RMA_GET, o->pktSize, 1, o) / pow(1024, 2);
+
+	rmaClose(&p);
+}
+
+/*
+ * Reponses automatiques aux tests RMA : la cible prend part aux memes epoques que l'origine.
+ */
+void responsesToRma(YourTest* t, Options* o) {
+	RmaPair p;
+
+	rmaOpen(t, &p, o);
+
+	rmaEpoch(&p, RMA_PUT, sizeof(int), 0, o);
+	rmaEpoch(&p, RMA_PUT, o->pktSize, 0, o);
+	rmaEpoch(&p, RMA_GET, sizeof(int), 0, o);
+	rmaEpoch(&p, RMA_GET, o->pktSize, 0, o);
+
+	rmaClose(&p);
+}
+
+/*
+ * Ouverture de la paire RMA : communicateur des deux seuls joueurs (MPI_Comm_create_group, qui n'implique pas les autres
+ * noeuds), fenetre de pktSize octets allouee par MPI (MPI_Win_allocate) et groupe du partenaire pour PSCW.
+ */
+void rmaOpen(YourTest* t, RmaPair* p, Options* o) {
+	MPI_Group world, pair;
+	int rank, ranks[2];
+
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+	ranks[0] = (rank < t->withRank) ? rank : t->withRank;
+	ranks[1] = (rank < t->withRank) ? t->withRank : rank;
+	p->peer = (t->withRank == ranks[0]) ? 0 : 1;
+
+	MPI_Comm_group(MPI_COMM_WORLD, &world);
+	MPI_Group_incl(world, 2, ranks, &pair);
+	MPI_Comm_create_group(MPI_COMM_WORLD, pair, 8, &p->comm);
+	MPI_Group_incl(pair, 1, &p->peer, &p->peerGroup);
+	MPI_Group_free(&pair);
+	MPI_Group_free(&world);
+
+	MPI_Win_allocate(o->pktSize, 1, MPI_INFO_NULL, p->comm, &p->base, &p->win);
+}
+
+void rmaClose(RmaPair* p) {
+	MPI_Win_free(&p->win);
+	MPI_Group_free(&p->peerGroup);
+	MPI_Comm_free(&p->comm);
+}
+
+/*
+ * Une epoque RMA d'une operation (Put ou Get de size octets entre le buffer de l'origine et la fenetre de la cible), avec la
+ * synchronisation choisie. Renvoie, pour l'origine, la duree de l'epoque : fence a fence, start a complete, ou de l'operation
+ * au flush sous verrou partage. La cible ne fait que les appels de synchronisation qui la concernent (aucun en passif).
+ */
+double rmaEpoch(RmaPair* p, int op, int size, int origin, Options* o) {
+	double start = 0, stop = 0;
+
+	switch(o->rma) {
+		case RMA_FENCE :
+			MPI_Win_fence(0, p->win);
+			start = timerNow();
+
+			if(origin)
+				rmaOp(p, op, size);
+
+			MPI_Win_fence(0, p->win);
+			stop = timerNow();
+		break;
+
+		case RMA_PSCW :
+			if(origin) {
+				start = timerNow();
+				MPI_Win_start(p->peerGroup, 0, p->win);
+				rmaOp(p, op, size);
+				MPI_Win_complete(p->win);
+				stop = timerNow();
+			} else {
+				MPI_Win_post(p->peerGroup, 0, p->win);
+				MPI_Win_wait(p->win);
+			}
+		break;
+
+		case RMA_LOCK :
+			if(origin) {
+				MPI_Win_lock(MPI_LOCK_SHARED, p->peer, 0, p->win);
+				start = timerNow();
+				rmaOp(p, op, size);
+				MPI_Win_flush(p->peer, p->win);
+				stop = timerNow();
+				MPI_Win_unlock(p->peer, p->win);
+			}
+		break;
+	}
+
+	return timerElapsed(start, stop);
+}
+
+void rmaOp(RmaPair* p, int op, int size) {
+	if(op == RMA_PUT)
+		MPI_Put(buffer, size, MPI_BYTE, p->peer, 0, size, MPI_BYTE, p->win);
+	else
+		MPI_Get(buffer, size, MPI_BYTE, p->peer, 0, size, MPI_BYTE, p->win);
+}
+
+/*
+ * Nom de la synchronisation RMA, tel qu'il est rappele dans les sorties.
+ */
+char* rmaSyncName(Options* o) {
+	char* names[4] = {"none", "fence", "pscw", "lock"};
+
+	return names[o->rma];
+}
+
+/*
+ * Latence dans chaque sens : l'envoyeur note la date de son envoi d'un mot vide, le receveur lui renvoie la date d'arrivee et
+ * celle de sa reponse, et l'envoyeur note l'arrivee de cette reponse. Chaque date est ramenee sur l'horloge du MASTER avec le
+ * decalage estime au debut des tests (la derive est corrigee a la fin par le MASTER, voir clockCorrect, a partir de la date du
+ * test, oneWayAt). Les chemins asymetriques donnent ainsi deux latences differentes, au lieu de la moitie de l'aller-retour.
+ */
+void oneWayTests(YourTest* t, Bench* r) {
+	double sent, received, times[2];
+	int me;
+
+	MPI_Comm_rank(MPI_COMM_WORLD, &me);
+	sent = timerNow();
+	MPI_Send(buffer, 0, MPI_BYTE, t->withRank, 10, MPI_COMM_WORLD);
+	MPI_Recv(times, 2, MPI_DOUBLE, t->withRank, 10, MPI_COMM_WORLD, &status);
+	received = timerNow();
+
+	r->oneWayOut = ((times[0] - clockOffset[t->withRank]) - (sent - clockOffset[me])) * 1e6;
+	r->oneWayIn = ((received - clockOffset[me]) - (times[1] - clockOffset[t->withRank])) * 1e6;
+	r->oneWayAt = sent - clockOffset[me] - clockOrigin;
+}
+
+/*
+ * Reponse au test de latence dans chaque sens : date d'arrivee du mot, puis date de depart de la reponse.
+ */
+void responsesToOneWay(YourTest* t) {
+	double times[2];
+
+	MPI_Recv(buffer, 0, MPI_BYTE, t->withRank, 10, MPI_COMM_WORLD, &status);
+	times[0] = timerNow();
+	times[1] = timerNow();
+	MPI_Send(times, 2, MPI_DOUBLE, t->withRank, 10, MPI_COMM_WORLD);
+}
+
+/*
+ * Estimation du decalage de l'horloge de chaque rank par rapport a celle du MASTER, un rank apres l'autre : le MASTER envoie
+ * CLOCK_SYNC_ROUNDS mots vides, le rank repond a chacun avec sa date, et seul l'aller-retour le plus court est garde (le moins
+ * perturbe). Le decalage est la date du rank moins le milieu de l'aller-retour, a plus ou moins la moitie de sa duree pres.
+ * Seul le MASTER remplit offset, error et at.
+ */
+void clockSync(int rank, int nbNodes, double* offset, double* error, double* at) {
+	double start, stop, remote, best;
+	int peer, i;
+
+	if(rank != MASTER) {
+		for(i = 0; i < CLOCK_SYNC_ROUNDS; i++) {
+			MPI_Recv(buffer, 0, MPI_BYTE, MASTER, 10, MPI_COMM_WORLD, &status);
+			remote = timerNow();
+			MPI_Send(&remote, 1, MPI_DOUBLE, MASTER, 10, MPI_COMM_WORLD);
+		}
+
+		return;
+	}
+
+	offset[MASTER] = error[MASTER] = at[MASTER] = 0;
+
+	for(peer = 1; peer < nbNodes; peer++) {
+		best = DBL_MAX;
+
+		for(i = 0; i < CLOCK_SYNC_ROUNDS; i++) {
+			start = timerNow();
+			MPI_Send(buffer, 0, MPI_BYTE, peer, 10, MPI_COMM_WORLD);
+			MPI_Recv(&remote, 1, MPI_DOUBLE, peer, 10, MPI_COMM_WORLD, &status);
+			stop = timerNow();
+
+			if(timerElapsed(start, stop) < best) {
+				best = timerElapsed(start, stop);
+				offset[peer] = remote - (start + stop) / 2;
+				error[peer] = best / 2;
+				at[peer] = (start + stop) / 2 - clockOrigin;
+			}
+		}
+	}
+}
+
+/*
+ * Premiere estimation des decalages, avant les tests : le MASTER les diffuse a tous les noeuds avec l'origine des dates, pour
+ * que chaque envoyeur ramene lui meme ses dates sur l'horloge du MASTER.
+ */
+void clockStart(int rank, int nbNodes, Clocks* c) {
+	clockOffset = (double*) malloc(sizeof(double) * nbNodes);
+	c->offset = clockOffset;
+	c->error = (double*) malloc(sizeof(double) * nbNodes);
+	c->at = (double*) malloc(sizeof(double) * nbNodes);
+	c->drift = (double*) malloc(sizeof(double) * nbNodes);
+
+	if(c->offset == NULL || c->error == NULL || c->at == NULL || c->drift == NULL) {
+		fprintf(stderr, "ERROR: Can't allocate memory.");
+		exit(1);
+	}
+
+	clockOrigin = timerNow();
+	clockSync(rank, nbNodes, c->offset, c->error, c->at);
+
+	MPI_Bcast(&clockOrigin, 1, MPI_DOUBLE, MASTER, MPI_COMM_WORLD);
+	MPI_Bcast(clockOffset, nbNodes, MPI_DOUBLE, MASTER, MPI_COMM_WORLD);
+}
+
+/*
+ * Seconde estimation des decalages, apres les tests : la derive de chaque horloge est la variation de son decalage divisee par
+ * le temps ecoule entre les deux estimations. L'incertitude gardee est la plus grande des deux.
+ */
+void clockEnd(int rank, int nbNodes, Clocks* c) {
+	double *offset, *error, *at;
+	int peer;
+
+	offset = (double*) malloc(sizeof(double) * nbNodes);
+	error = (double*) malloc(sizeof(double) * nbNodes);
+	at = (double*) malloc(sizeof(double) * nbNodes);
+
+	if(offset == NULL || error == NULL || at == NULL) {
+		fprintf(stderr, "ERROR: Can't allocate memory.");
+		exit(1);
+	}
+
+	clockSync(rank, nbNodes, offset, error, at);
+
+	if(rank == MASTER) {
+		c->drift[MASTER] = 0;
+
+		for(peer = 1; peer < nbNodes; peer++) {
+			c->drift[peer] = (at[peer] > c->at[peer]) ? (offset[peer] - c->offset[peer]) / (at[peer] - c->at[peer]) : 0;
+
+			if(error[peer] > c->error[peer])
+				c->error[peer] = error[peer];
+		}
+	}
+
+	free(offset);
+	free(error);
+	free(at);
+}
+
+/*
+ * Correction de la derive des horloges sur les latences dans chaque sens : a la date du test, le decalage de chaque rank a
+ * varie de sa derive multipliee par le temps ecoule depuis sa premiere estimation, au lieu du decalage initial utilise par
+ * l'envoyeur.
+ */
+void clockCorrect(Results* r, Clocks* c) {
+	double shift;
+	float at;
+	int sender, recver;
+
+	for(sender = 1; sender < r->nbNodes; sender++) {
+		for(recver = 1; recver < r->nbNodes; recver++) {
+			at = RESULT(r, offsetof(Bench, oneWayAt), sender, recver);
+
+			if(!resultTested(r, sender, recver) || at < 0)
+				continue;
+
+			shift = (c->drift[recver] * (at - c->at[recver]) - c->drift[sender] * (at - c->at[sender])) * 1e6;
+			RESULT(r, offsetof(Bench, oneWayOut), sender, recver) -= shift;
+			RESULT(r, offsetof(Bench, oneWayIn), sender, recver) += shift;
+		}
+	}
+}
+
+/*
+ * Remplissage d'un mot de size octets par un motif xorshift64 tire de seed, suivi du CRC32C de tout ce qui precede (4 octets).
+ */
+void integrityFill(char* buf, int size, unsigned long long seed) {
+	unsigned long long x = seed * 0x9E3779B97F4A7C15ULL + 1;
+	unsigned int crc;
+	int i, len = size - sizeof(crc);
+
+	for(i = 0; i + 8 <= len; i += 8) {
+		x ^= x << 13;
+		x ^= x >> 7;
+		x ^= x << 17;
+		memcpy(buf + i, &x, 8);
+	}
+
+	for(; i < len; i++)
+		buf[i] = (char) (x >> (8 * (i % 8)));
+
+	crc = crc32c(buf, len);
+	memcpy(buf + len, &crc, sizeof(crc));
+}
+
+/*
+ * Preparation du CRC32C : table de la version logicielle, et detection de l'instruction crc32 de SSE4.2.
+ */
+void crc32cInit() {
+	unsigned int c;
+	int i, k;
+
+	for(i = 0; i < 256; i++) {
+		for(c = i, k = 0; k < 8; k++)
+			c = (c & 1) ? (c >> 1) ^ 0x82F63B78 : c >> 1;
+
+		crc32cTable[i] = c;
+	}
+
+#if defined(__x86_64__)
+	crc32cHard = __builtin_cpu_supports("sse4.2");
+#endif
+}
+
+/*
+ * CRC32C (Castagnoli) de len octets : instruction crc32 de SSE4.2 (8 octets par instruction) si le processeur l'a, sinon
+ * table d'un octet a la fois.
+ */
+unsigned int crc32c(const void* data, size_t len) {
+	const unsigned char* p = (const unsigned char*) data;
+	unsigned int c = 0xFFFFFFFF;
+
+#if defined(__x86_64__)
+	if(crc32cHard)
+		return crc32cSSE42(p, len);
+#endif
+
+	while(len--)
+		c = crc32cTable[(c ^ *p++) & 0xFF] ^ (c >> 8);
+
+	return ~c;
+}
+
+#if defined(__x86_64__)
+__attribute__((target("sse4.2")))
+unsigned int crc32cSSE42(const unsigned char* p, size_t len) {
+	unsigned long long c = 0xFFFFFFFF, word;
+
+	for(; len >= 8; p += 8, len -= 8) {
+		memcpy(&word, p, 8);
+		c = _mm_crc32_u64(c, word);
+	}
+
+	for(; len > 0; p++, len--)
+		c = _mm_crc32_u8((unsigned int) c, *p);
+
+	return ~(unsigned int) c;
+}
+#endif
+
+/*
+ * Reponses automatiques au test de debit bidirectionnel : meme echange que l'envoyeur, des son mot de depart, en acquittant
+ * la reception de son mot des qu'elle est terminee.
+ */
+void responsesToBidir(YourTest* t, Options* o) {
+	MPI_Request requests[2];
+
+	MPI_Irecv((char*) buffer + o->pktSize, o->pktSize, MPI_BYTE, t->withRank, 3, MPI_COMM_WORLD, &requests[0]);
+
+	MPI_Recv(buffer, 0, MPI_BYTE, t->withRank, 4, MPI_COMM_WORLD, &status);
+	MPI_Isend(buffer, o->pktSize, MPI_BYTE, t->withRank, 3, MPI_COMM_WORLD, &requests[1]);
+
+	MPI_Wait(&requests[0], MPI_STATUS_IGNORE);
+	MPI_Send(buffer, 0, MPI_BYTE, t->withRank, 4, MPI_COMM_WORLD);
+
+	MPI_Wait(&requests[1], MPI_STATUS_IGNORE);
+}
+
+/*
+ * Reponses automatiques au test de debit en flux continu. Les receptions de chaque fenetre sont postees avant l'acquittement
+ * de la precedente, afin que les mots de l'envoyeur ne trouvent jamais le receveur sans reception en attente.
+ */
+void responsesToStream(YourTest* t, Options* o) {
+	int w, j;
+	MPI_Request* requests;
+
+	requests = (MPI_Request*) malloc(sizeof(MPI_Request) * o->window);
+
+	if(requests == NULL) {
+		fprintf(stderr, "ERROR: Can't allocate memory.");
+		exit(1);
+	}
+
+	for(j = 0; j < o->window; j++)
+		MPI_Irecv((char*) buffer + (size_t) j * o->pktSize, o->pktSize, MPI_BYTE, t->withRank, 2, MPI_COMM_WORLD, &requests[j]);
+
+	for(w = 0; w < o->nbWindows; w++) {
+		MPI_Waitall(o->window, requests, MPI_STATUSES_IGNORE);
+
+		/* Pre-post de la fenetre suivante, puis acquittement de la fenetre courante */
+		if(w < o->nbWindows - 1) {
+			for(j = 0; j < o->window; j++)
+				MPI_Irecv((char*) buffer + (size_t) j * o->pktSize, o->pktSize, MPI_BYTE, t->withRank, 2, MPI_COMM_WORLD, &requests[j]);
+		}
+
+		MPI_Send(buffer, 0, MPI_BYTE, t->withRank, 2, MPI_COMM_WORLD);
+	}
+
+	free(requests);
+}
+
+/*
+ * Balayage des tailles de messages (option -S), de l'envoyeur vers le receveur. Pour chaque taille, un mot est envoye et
+ * le receveur renvoie un mot de la meme taille (ping-pong) : la latence est la moitie de l'aller-retour, et le debit la taille
+ * divisee par cette latence. Contrairement a l'approche NWS, cette mesure reste valable pour les petits messages, ce qui permet
+ * de voir le passage eager/rendezvous et la taille n1/2. La courbe est ecrite dans series (latences puis debits).
+ */
+void sweepTests(YourTest* t, float* series, Options* o) {
+	double start, stop;
+	int k;
+
+	for(k = 0; k < o->nbSizes; k++) {
+		start = timerNow();
+		MPI_Send(buffer, o->sizes[k], MPI_BYTE, t->withRank, 1, MPI_COMM_WORLD);
+		MPI_Recv(buffer, o->sizes[k], MPI_BYTE, t->withRank, 1, MPI_COMM_WORLD, &status);
+		stop = timerNow();
+
+		/* Latence en microsecondes, debit en Mo/s */
+		series[k] = (timerElapsed(start, stop) / 2) * 1e6;
+		series[o->nbSizes + k] = o->sizes[k] / (timerElapsed(start, stop) / 2) / pow(1024, 2);
+	}
+}
+
+/*
+ * Reponses automatiques au balayage des tailles de l'envoyeur.
+ */
+void responsesToSweep(YourTest* t, Options* o) {
+	int k;
+
+	for(k = 0; k < o->nbSizes; k++) {
+		MPI_Recv(buffer, o->sizes[k], MPI_BYTE, t->withRank, 1, MPI_COMM_WORLD, &status);
+		MPI_Send(buffer, o->sizes[k], MPI_BYTE, t->withRank, 1, MPI_COMM_WORLD);
+	}
+}
+
+/*
+ * Creation de tous les tests qui seront repartis entre tous les noeuds, pour le mode bissection, sans les envoyer et en les
+ * stockant dans un tableau.
+ */
+void bissPrepareAllTests(YourTest* bissTests, int nbNodes) {
+	int m, i;
+	YourTest t;
+
+	/* Le rank 0 ne participe pas */
+	nbNodes--;
+
+	/* Si il y a un nb impaire de noeud, on ignore le dernier, en le faisant quand meme participer
+	aux fonctions collectives*/
+	if(nbNodes % 2) {
+		bissTests[nbNodes].role = DEACTIVATED;
+		bissTests[nbNodes].withRank = -1;
+		nbNodes--;
+	}
+
+	m = nbNodes / 2;
+
+	/* Pour chaque paire */
+	for(i = 1; i <= m; i++) {
+
+		/* Le receveur de la paire est le n ieme de la seconde moitie */
+		bissTests[m+i].role = RECVER;
+		bissTests[m+i].withRank = i;
+
+		/* L'envoyeur est le n ieme de la premiere moitie */
+		bissTests[i].role = SENDER;
+		bissTests[i].withRank = m+i;
+	}
+}
+
+/*
+ * Creations des tests pour la bissection, en creant les paires de noeuds de facon aleatoire (sans envoyer les tests,
+ * et en les stockant dans un tableau.
+ */
+void bissPrepareAllRandTests(YourTest* bissTests, int nbNodes) {
+	int i, r, randRank, ranks[2], iLeft, *ranksLeft, nbLeft;
+	YourTest t;
+
+	/* Le rank 0 ne participe pas */
+	nbNodes--;
+
+	/* Si il y a un nb impaire de noeud, on ignore le dernier, en le faisant quand meme participer
+	aux fonctions collectives*/
+	if(nbNodes % 2) {
+		bissTests[nbNodes].role = DEACTIVATED;
+		bissTests[nbNodes].withRank = -1;
+		nbNodes--;
+	}
+
+	/* Nombre et liste des noeuds qui n'ont pas encore de test attribue */
+	nbLeft = nbNodes;
+	ranksLeft = (int*) malloc(sizeof(int) * nbLeft);
+
+	if(ranksLeft == NULL) {
+		fprintf(stderr, "ERROR: Can't allocate memory.");
+		exit(1);
+	}
+
+	/* Initialisation des noeuds : avec la valeur 1, chacun est encore vaquant */
+	for(i = 0; i < nbLeft; ranksLeft[i++] = 1);
+
+	/* Pour tous les noeuds vaquants restants */
+	while(nbLeft != 0) {
+
+		/* Extraction de deux noeuds choisis aleatoirement parmis les noeuds encore disponibles
+		Premier tour pour l'envoyeur, second tour pour le receveur */
+		for(i = 0; i < 2; i++) {
+			srand(time(NULL));
+
+			/* Tirage d'un nombre aleatoire qui definira le rank du noeud choisi, parmis les ranks restants.
+			Ex: si 3 est tire, le rank selectionne sera le 3ieme qui n'a pas encore ete utilise */
+			randRank = rand() % (nbLeft-1);
+
+			r = -1;
+			iLeft = 0;
+			ranks[i] = -1;
+
+			/* Pour tous les ranks jusqu'a ce que le n ieme rank encore vaquant soit atteint */
+			while(ranks[i] == -1) {
+
+				/* Si le rank en cours est encore vaquant */
+				if(ranksLeft[++r] != -1) {
+
+					/* Si le rank en cours correspond au rank du tirage aleatoire, selection de ce rank (+1, puisque le rank 0 a ete supprime) */
+					if(iLeft == randRank)
+						ranks[i] = r + 1;
+
+					/*  Sinon incrementation du nb des ranks encore vaquants deja rencontres */
+					iLeft++;
+				}
+			}
+
+			/* Ce rank ne pourra plus etre selectionne */
+			ranksLeft[r] = -1;
+		}
+
+		/* Deux ranks en moins a attribuer */
+		nbLeft -= 2;
+
+		/* Creation du test du receveur, qui attendra alors un message de son camarade de jeu */
+		bissTests[ranks[1]].role = RECVER;
+		bissTests[ranks[1]].withRank = ranks[0];
+
+		/* Creation du test de l'envoyeur */
+		bissTests[ranks[0]].role = SENDER;
+		bissTests[ranks[0]].withRank = ranks[1];
+	}
+}
+
+/*
+ * Nombre de tours du tournoi round-robin de la matrice concurrente. Les noeuds de test (sans le rank 0) sont completes par
+ * un joueur fictif si leur nombre est impair : chaque tour, celui qui lui est associe est desactive. La premiere moitie des
+ * tours couvre chaque paire dans un sens, la seconde moitie dans l'autre.
+ */
+int rrNbRounds(int nbNodes) {
+	int m = (nbNodes-1) + (nbNodes-1) % 2;
+
+	return 2 * (m-1);
+}
+
+/*
+ * Creation des tests d'un tour du tournoi round-robin (methode du cercle), sans les envoyer et en les stockant dans un tableau,
+ * comme pour la bissection. Le premier joueur reste fixe, les autres tournent d'un cran a chaque tour.
+ */
+void rrPrepareRoundTests(YourTest* bissTests, int nbNodes, int round) {
+	int m, half, i, a, b, tmp;
+
+	/* Nombre de joueurs (pair) et indice du tour dans la moitie courante */
+	m = (nbNodes-1) + (nbNodes-1) % 2;
+	half = round % (m-1);
+
+	/* Le rank 0 ne participe pas */
+	bissTests[MASTER].role = DEACTIVATED;
+	bissTests[MASTER].withRank = -1;
+
+	for(i = 0; i < m/2; i++) {
+
+		/* Joueurs face a face sur le cercle, decales de +1 pour retrouver leur rank */
+		a = (i == 0 ? 0 : 1 + (i-1 + half) % (m-1)) + 1;
+		b = 1 + (m-2-i + half) % (m-1) + 1;
+
+		/* Seconde moitie du tournoi : le sens des paires est inverse */
+		if(round >= m-1) {
+			tmp = a;
+			a = b;
+			b = tmp;
+		}
+
+		/* Le joueur fictif (rank inexistant) desactive son adversaire pour ce tour */
+		if(a >= nbNodes || b >= nbNodes) {
+			tmp = (a >= nbNodes) ? b : a;
+			bissTests[tmp].role = DEACTIVATED;
+			bissTests[tmp].withRank = -1;
+			continue;
+		}
+
+		bissTests[a].role = SENDER;
+		bissTests[a].withRank = b;
+
+		bissTests[b].role = RECVER;
+		bissTests[b].withRank = a;
+	}
+}
+
+/*
+ * Generateur pseudo-aleatoire congruentiel, pour que tous les noeuds tirent exactement la meme suite a partir de la meme graine,
+ * quelle que soit leur libc.
+ */
+unsigned int distRand(unsigned int* state) {
+	*state = *state * 1103515245 + 12345;
+
+	return (*state >> 16) & 0x7fff;
+}
+
+/*
+ * Creation des tests d'un tour de la matrice concurrente distribuee : le tour du tournoi round-robin, dont les joueurs sont
+ * melanges par une permutation des ranks tiree de la graine. Tous les noeuds obtiennent ainsi le meme tableau sans communiquer.
+ */
+void distPrepareRoundTests(YourTest* bissTests, int nbNodes, int round, unsigned int seed) {
+	YourTest* tests = (YourTest*) malloc(sizeof(YourTest)*nbNodes);
+	int* perm = (int*) malloc(sizeof(int)*nbNodes);
+	int i, j, tmp;
+
+	if(tests == NULL || perm == NULL) {
+		fprintf(stderr, "ERROR: Can't allocate memory.");
+		exit(1);
+	}
+
+	/* Melange de Fisher-Yates des ranks des noeuds testes, le MASTER restant a sa place */
+	for(i = 0; i < nbNodes; i++)
+		perm[i] = i;
+
+	for(i = nbNodes-1; i > 1; i--) {
+		j = 1 + distRand(&seed) % i;
+		tmp = perm[i];
+		perm[i] = perm[j];
+		perm[j] = tmp;
+	}
+
+	rrPrepareRoundTests(tests, nbNodes, round);
+
+	for(i = 0; i < nbNodes; i++) {
+		bissTests[perm[i]].role = tests[i].role;
+		bissTests[perm[i]].withRank = (tests[i].role == DEACTIVATED) ? -1 : perm[tests[i].withRank];
+	}
+
+	free(tests);
+	free(perm);
+}
+
+/*
+ * Tirage des partenaires du mode echantillonne (option -K) : K decalages distincts parmi 1 a P-1 (P ranks testes), tires de la
+ * graine par un melange de Fisher-Yates partiel. Le rank d'indice i envoie au rank d'indice i + decalage (modulo P) : chaque
+ * decalage est une permutation, et chaque rank est donc envoyeur K fois et receveur K fois. Au dela de P-1, c'est la matrice
+ * complete.
+ */
+void sampleInit(Topology* t, Options* o) {
+	unsigned int seed = o->seed;
+	int p = t->nbPlayers - 1, *all, rank, i, j, tmp;
+
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+	if(p < 2) {
+		if(rank == MASTER)
+			fprintf(stderr, "ERROR: The -K option requires at least 2 tested ranks.");
+
+		exit(1);
+	}
+
+	if(o->sampled > p - 1)
+		o->sampled = p - 1;
+
+	all = (int*) malloc(sizeof(int) * p);
+	o->shifts = (int*) malloc(sizeof(int) * o->sampled);
+
+	if(all == NULL || o->shifts == NULL) {
+		fprintf(stderr, "ERROR: Can't allocate memory.");
+		exit(1);
+	}
+
+	for(i = 0; i < p - 1; i++)
+		all[i] = i + 1;
+
+	for(i = 0; i < o->sampled; i++) {
+		j = i + distRand(&seed) % (p - 1 - i);
+		tmp = all[i];
+		all[i] = all[j];
+		all[j] = tmp;
+		o->shifts[i] = all[i];
+	}
+
+	free(all);
+}
+
+/*
+ * Indice (dans la liste des ranks testes, a partir de 1) du partenaire de l'indice i pour un decalage.
+ */
+int samplePartner(int i, int shift, int nbPlayers) {
+	return 1 + (i - 1 + shift) % (nbPlayers - 1);
+}
+
+/*
+ * Creation des tests d'un tour de la matrice concurrente en mode echantillonne, sur les indices des ranks testes (voir
+ * topoMapTests). Les liens d'un decalage forment pgcd(P, decalage) cycles de P / pgcd liens ; en alternant les liens de chaque
+ * cycle sur deux tours (le dernier lien d'un cycle impair sur un troisieme), aucun rank ne joue deux fois dans un meme tour.
+ */
+void samplePrepareRoundTests(YourTest* bissTests, int nbPlayers, int round, Options* o) {
+	int p = nbPlayers - 1, shift = o->shifts[round / SAMPLE_ROUNDS], part = round % SAMPLE_ROUNDS, g, len, c, t, a, b;
+
+	for(a = 0; a < nbPlayers; a++) {
+		bissTests[a].role = DEACTIVATED;
+		bissTests[a].withRank = -1;
+	}
+
+	for(g = p, b = shift; b > 0; t = g % b, g = b, b = t);
+
+	len = p / g;
+
+	for(c = 0; c < g; c++) {
+		for(t = 0; t < len; t++) {
+			if(((t == len - 1 && len % 2) ? 2 : t % 2) != part)
+				continue;
+
+			a = 1 + (c + t * shift) % p;
+			b = samplePartner(a, shift, nbPlayers);
+
+			bissTests[a].role = SENDER;
+			bissTests[a].withRank = b;
+
+			bissTests[b].role = RECVER;
+			bissTests[b].withRank = a;
+		}
+	}
+}
+
+/*
+ * Fonction collective d'envoi au MASTER de tous les resultats gardes par chaque noeud en mode distribue (nb resultats et leurs
+ * courbes du balayage), en un seul MPI_Gatherv. Le MASTER les range directement dans les matrices r et dans celle des courbes.
+ */
+void distTransmitAllResults(Bench* myResults, float* mySweeps, int nb, Results* r, float* sweep, Options* o) {
+	int *counts = NULL, *displs = NULL, total = 0, rank, nbNodes, i;
+	Bench* all = NULL;
+	float* allSweeps = NULL;
+
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &nbNodes);
+
+	if(rank == MASTER) {
+		counts = (int*) malloc(sizeof(int)*nbNodes);
+		displs = (int*) malloc(sizeof(int)*nbNodes);
+
+		if(counts == NULL || displs == NULL) {
+			fprintf(stderr, "ERROR: Can't allocate memory.");
+			exit(1);
+		}
+	}
+
+	MPI_Gather(&nb, 1, MPI_INT, counts, 1, MPI_INT, MASTER, MPI_COMM_WORLD);
+
+	if(rank == MASTER) {
+		for(i = 0; i < nbNodes; i++) {
+			displs[i] = total;
+			total += counts[i];
+		}
+
+		all = (Bench*) malloc(sizeof(Bench) * (total + 1));
+		allSweeps = (float*) malloc(sizeof(float) * (2 * o->nbSizes * total + 1));
+
+		if(all == NULL || allSweeps == NULL) {
+			fprintf(stderr, "ERROR: Can't allocate memory.");
+			exit(1);
+		}
+	}
+
+	MPI_Gatherv(myResults, nb, BenchType, all, counts, displs, BenchType, MASTER, MPI_COMM_WORLD);
+
+	/* Les courbes suivent, dans le meme ordre, avec 2*nbSizes flottants par resultat */
+	if(o->nbSizes > 0) {
+		if(rank == MASTER) {
+			for(i = 0; i < nbNodes; i++) {
+				counts[i] *= 2 * o->nbSizes;
+				displs[i] *= 2 * o->nbSizes;
+			}
+		}
+
+		MPI_Gatherv(mySweeps, nb * 2 * o->nbSizes, MPI_FLOAT, allSweeps, counts, displs, MPI_FLOAT, MASTER, MPI_COMM_WORLD);
+	}
+
+	if(rank == MASTER) {
+		for(i = 0; i < total; i++) {
+			storeResult(r, &all[i]);
+
+			if(o->nbSizes > 0)
+				memcpy(sweepOf(sweep, all[i].sender, all[i].recver, nbNodes, o), &allSweeps[i * 2 * o->nbSizes], sizeof(float) * 2 * o->nbSizes);
+		}
+
+		free(counts);
+		free(displs);
+		free(all);
+		free(allSweeps);
+	}
+}
+
+/*
+ * Nombre de paliers du test incast/outcast : K = 1, 2, 4... jusqu'a fan (inclus, meme si ce n'est pas une puissance de 2).
+ */
+int fanNbSteps(Options* o) {
+	int k, nb = 0;
+
+	for(k = 1; k < o->fan; k *= 2)
+		nb++;
+
+	return nb + 1;
+}
+
+/*
+ * Nombre de noeuds face au premier pour le palier step.
+ */
+int fanPeers(int step, Options* o) {
+	return (step == fanNbSteps(o) - 1) ? o->fan : 1 << step;
+}
+
+/*
+ * Debits de chaque transfert du palier step dans un sens (0 : incast, 1 : outcast), ranges comme un tableau de fan flottants.
+ */
+float* fanOf(float* flows, int step, int dir, Options* o) {
+	return &flows[(step * 2 + dir) * o->fan];
+}
+
+/*
+ * Deroulement complet du test incast/outcast, pour tous les noeuds. Le rank 1 est le noeud central ; pour chaque palier, les
+ * ranks 2 a K+1 lui envoient chacun un mot de pktSize octets en meme temps (incast), puis il leur en envoie un a chacun en meme
+ * temps (outcast). Chaque transfert est chronometre par son envoyeur, jusqu'a l'acquittement du receveur, et sa duree moyenne
+ * sur les nbRetry repetitions (echauffement exclu) donne son debit. Le MASTER donne les departs synchro et recoit les debits.
+ */
+void fanAllTests(int rank, int nbNodes, char* hostnames, Options* o) {
+	int step, k, dir, i, p;
+	float *flows, *times;
+
+	flows = (float*) malloc(sizeof(float) * fanNbSteps(o) * 2 * o->fan);
+	times = (float*) malloc(sizeof(float) * o->fan);
+
+	if(flows == NULL || times == NULL) {
+		fprintf(stderr, "ERROR: Can't allocate memory.");
+		exit(1);
+	}
+
+	for(step = 0; step < fanNbSteps(o); step++) {
+		k = fanPeers(step, o);
+
+		for(dir = 0; dir < 2; dir++) {
+			for(p = 0; p < k; p++)
+				times[p] = 0;
+
+			for(i = 0; i < o->warmup + o->nbRetry; i++) {
+				bissLaunchAllTests();
+
+				if(rank == 1 && dir == 0)
+					responsesToIncast(k, o);
+				else if(rank == 1)
+					outcastTests(k, times, i >= o->warmup, o);
+				else if(rank >= 2 && rank <= k + 1 && dir == 0)
+					incastTests(times, i >= o->warmup, o);
+				else if(rank >= 2 && rank <= k + 1)
+					responsesToOutcast(o);
+			}
+
+			/* Le chronometreur de chaque transfert (l'envoyeur) en renvoie le debit moyen au MASTER */
+			if(rank == MASTER) {
+				for(p = 0; p < k; p++)
+					MPI_Recv(&fanOf(flows, step, dir, o)[p], 1, MPI_FLOAT, dir == 0 ? p + 2 : 1, 0, MPI_COMM_WORLD, &status);
+
+			} else if((dir == 0 && rank >= 2 && rank <= k + 1) || (dir == 1 && rank == 1)) {
+				for(p = 0; p < (dir == 0 ? 1 : k); p++) {
+					times[p] = o->pktSize / (times[p] / o->nbRetry) / pow(1024, 2);
+					MPI_Send(&times[p], 1, MPI_FLOAT, MASTER, 0, MPI_COMM_WORLD);
+				}
+			}
+		}
+	}
+
+	if(rank == MASTER) {
+		if(o->yaml)
+			fanToYAML(flows, rankToHostname(hostnames, 1), o->yamlFile, o);
+
+		displayFan(flows, rankToHostname(hostnames, 1), o);
+	}
+
+	free(flows);
+	free(times);
+}
+
+/*
+ * Incast, cote envoyeur : envoi d'un mot de pktSize octets au noeud central, en meme temps que les autres, et attente de son
+ * acquittement. La duree est cumulee dans times[0] si la repetition est comptee.
+ */
+void incastTests(float* times, int kept, Options* o) {
+	double start = timerNow();
+
+	MPI_Send(buffer, o->pktSize, MPI_BYTE, 1, 6, MPI_COMM_WORLD);
+	MPI_Recv(buffer, 0, MPI_BYTE, 1, 6, MPI_COMM_WORLD, &status);
+
+	if(kept)
+		times[0] += timerElapsed(start, timerNow());
+}
+
+/*
+ * Incast, cote noeud central : reception des k mots, chacun dans sa zone du buffer, et acquittement de chacun des qu'il est arrive.
+ */
+void responsesToIncast(int k, Options* o) {
+	MPI_Request* requests = (MPI_Request*) malloc(sizeof(MPI_Request) * k);
+	int p, done;
+
+	if(requests == NULL) {
+		fprintf(stderr, "ERROR: Can't allocate memory.");
+		exit(1);
+	}
+
+	for(p = 0; p < k; p++)
+		MPI_Irecv((char*) buffer + (size_t) p * o->pktSize, o->pktSize, MPI_BYTE, p + 2, 6, MPI_COMM_WORLD, &requests[p]);
+
+	for(done = 0; done < k; done++) {
+		MPI_Waitany(k, requests, &p, &status);
+		MPI_Send(buffer, 0, MPI_BYTE, p + 2, 6, MPI_COMM_WORLD);
+	}
+
+	free(requests);
+}
+
+/*
+ * Outcast, cote noeud central : envoi d'un mot de pktSize octets a chacun des k noeuds en meme temps, et attente de leurs
+ * acquittements. La duree de chaque transfert (jusqu'a son acquittement) est cumulee dans times si la repetition est comptee.
+ */
+void outcastTests(int k, float* times, int kept, Options* o) {
+	MPI_Request* requests = (MPI_Request*) malloc(sizeof(MPI_Request) * 2 * k);
+	double start;
+	int p, done;
+
+	if(requests == NULL) {
+		fprintf(stderr, "ERROR: Can't allocate memory.");
+		exit(1);
+	}
+
+	start = timerNow();
+
+	for(p = 0; p < k; p++) {
+		MPI_Irecv(NULL, 0, MPI_BYTE, p + 2, 6, MPI_COMM_WORLD, &requests[p]);
+		MPI_Isend(buffer, o->pktSize, MPI_BYTE, p + 2, 6, MPI_COMM_WORLD, &requests[k + p]);
+	}
+
+	for(done = 0; done < k; done++) {
+		MPI_Waitany(k, requests, &p, &status);
+
+		if(kept)
+			times[p] += timerElapsed(start, timerNow());
+	}
+
+	MPI_Waitall(k, &requests[k], MPI_STATUSES_IGNORE);
+	free(requests);
+}
+
+/*
+ * Outcast, cote receveur : reception du mot du noeud central et acquittement.
+ */
+void responsesToOutcast(Options* o) {
+	MPI_Recv(buffer, o->pktSize, MPI_BYTE, 1, 6, MPI_COMM_WORLD, &status);
+	MPI_Send(buffer, 0, MPI_BYTE, 1, 6, MPI_COMM_WORLD);
+}
+
+/*
+ * Indice d'equite de Jain des k debits : (somme)^2 / (k * somme des carres), 1 si tous sont egaux, 1/k si un seul transfert
+ * accapare le lien.
+ */
+float jainIndex(float* flows, int k) {
+	double sum = 0, sumSq = 0;
+	int p;
+
+	for(p = 0; p < k; p++) {
+		sum += flows[p];
+		sumSq += flows[p] * flows[p];
+	}
+
+	return (sumSq > 0) ? sum * sum / (k * sumSq) : 0;
+}
+
+/*
+ * Debit agrege de k transferts simultanes de pktSize octets : le volume total divise par la duree du plus lent.
+ */
+float fanAggregate(float* flows, int k) {
+	float min = flows[0];
+	int p;
+
+	for(p = 1; p < k; p++) {
+		if(flows[p] < min)
+			min = flows[p];
+	}
+
+	return k * min;
+}
+
+/*
+ * Recherche de l'option -n dans la ligne de commande, avant MPI_Init (et donc avant getopt) : les options groupees (ex. -bn4)
+ * sont parcourues jusqu'a la premiere qui attend un argument.
+ */
+int threadsRequested(int argc, char** argv) {
+	char* c;
+	int i;
+
+	for(i = 1; i < argc; i++) {
+		if(argv[i][0] != '-')
+			continue;
+
+		for(c = argv[i] + 1; *c != '\0'; c++) {
+			if(*c == 'n')
+				return 1;
+
+			if(strchr(OPTIONS_WITH_ARG, *c) != NULL) {
+				if(c[1] == '\0')
+					i++;
+
+				break;
+			}
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Nombre d'etapes du test multi threads : 1, 2, 4... threads, puis T si ce n'est pas une puissance de 2.
+ */
+int threadsNbSteps(Options* o) {
+	int k, nb = 1;
+
+	for(k = 1; k < o->threads; k *= 2)
+		nb++;
+
+	return nb;
+}
+
+/*
+ * Nombre de threads par rank de l'etape step.
+ */
+int threadsOf(int step, Options* o) {
+	return (step == threadsNbSteps(o) - 1) ? o->threads : 1 << step;
+}
+
+/*
+ * Mode multi threads (option -n) : les paires de la bissection (le n-ieme noeud de la premiere moitie avec le n-ieme de la
+ * seconde) sont testees en meme temps, avec 1, 2, 4... jusqu'a T threads par rank. Chaque thread a son propre communicateur
+ * (duplique une fois pour toutes avant les tests), ce qui garde les flux separes dans la bibliotheque MPI. L'envoyeur garde le
+ * debit de chacun de ses threads, et tous les debits sont recueillis par le MASTER a la fin.
+ */
+void threadsAllTests(int rank, int nbNodes, char* hostnames, Options* o) {
+	ThreadStream* streams;
+	pthread_t* threads;
+	MPI_Comm* comms;
+	int half = (nbNodes - 1) / 2, nbFlows = threadsNbSteps(o) * o->threads, role = DEACTIVATED, peer = -1, step, k, t;
+	float *flows, *allFlows = NULL;
+
+	if(rank >= 1 && rank <= half) {
+		role = SENDER;
+		peer = rank + half;
+
+	} else if(rank > half && rank <= 2 * half) {
+		role = RECVER;
+		peer = rank - half;
+	}
+
+	streams = (ThreadStream*) malloc(sizeof(ThreadStream) * o->threads);
+	threads = (pthread_t*) malloc(sizeof(pthread_t) * o->threads);
+	comms = (MPI_Comm*) malloc(sizeof(MPI_Comm) * o->threads);
+	flows = (float*) malloc(sizeof(float) * nbFlows);
+
+	if(rank == MASTER)
+		allFlows = (float*) malloc(sizeof(float) * nbFlows * nbNodes);
+
+	if(streams == NULL || threads == NULL || comms == NULL || flows == NULL || (rank == MASTER && allFlows == NULL)) {
+		fprintf(stderr, "ERROR: Can't allocate memory.");
+		exit(1);
+	}
+
+	for(k = 0; k < nbFlows; flows[k++] = -1);
+
+	/* La duplication est collective : tous les ranks y participent, meme ceux qui ne sont pas testes */
+	for(t = 0; t < o->threads; t++) {
+		MPI_Comm_dup(MPI_COMM_WORLD, &comms[t]);
+
+		streams[t].role = role;
+		streams[t].peer = peer;
+		streams[t].comm = comms[t];
+		streams[t].o = o;
+		streams[t].buf = NULL;
+
+		if(role != DEACTIVATED && (streams[t].buf = (char*) calloc(o->pktSize, 1)) == NULL) {
+			fprintf(stderr, "ERROR: Can't allocate memory.");
+			exit(1);
+		}
+	}
+
+	for(step = 0; step < threadsNbSteps(o); step++) {
+		k = threadsOf(step, o);
+		bissLaunchAllTests();
+
+		if(role == DEACTIVATED)
+			continue;
+
+		for(t = 0; t < k; t++) {
+			if(pthread_create(&threads[t], NULL, threadStream, &streams[t]) != 0) {
+				fprintf(stderr, "ERROR: Can't create thread.");
+				exit(1);
+			}
+		}
+
+		for(t = 0; t < k; t++) {
+			pthread_join(threads[t], NULL);
+
+			if(role == SENDER)
+				flows[step * o->threads + t] = (double) o->pktSize * o->nbRetry / streams[t].time / pow(1024, 2);
+		}
+	}
+
+	MPI_Gather(flows, nbFlows, MPI_FLOAT, allFlows, nbFlows, MPI_FLOAT, MASTER, MPI_COMM_WORLD);
+
+	if(rank == MASTER) {
+		if(o->yaml)
+			threadsToYAML(allFlows, hostnames, nbNodes, o->yamlFile, o);
+
+		displayThreads(allFlows, hostnames, nbNodes, o);
+		free(allFlows);
+	}
+
+	for(t = 0; t < o->threads; t++) {
+		MPI_Comm_free(&comms[t]);
+		free(streams[t].buf);
+	}
+
+	free(streams);
+	free(threads);
+	free(comms);
+	free(flows);
+}
+
+/*
+ * Flux d'un thread : apres les repetitions d'echauffement, l'envoyeur envoie nbRetry mots de pktSize octets a la suite, et
+ * attend un seul acquittement du receveur une fois le dernier recu. Le statut global n'est pas utilise (threads).
+ */
+void* threadStream(void* arg) {
+	ThreadStream* s = (ThreadStream*) arg;
+	Options* o = s->o;
+	double start = timerNow();
+	int i;
+
+	for(i = 0; i < o->warmup + o->nbRetry; i++) {
+		if(i == o->warmup)
+			start = timerNow();
+
+		if(s->role == SENDER)
+			MPI_Send(s->buf, o->pktSize, MPI_BYTE, s->peer, 9, s->comm);
+		else
+			MPI_Recv(s->buf, o->pktSize, MPI_BYTE, s->peer, 9, s->comm, MPI_STATUS_IGNORE);
+	}
+
+	if(s->role == SENDER)
+		MPI_Recv(NULL, 0, MPI_BYTE, s->peer, 9, s->comm, MPI_STATUS_IGNORE);
+	else
+		MPI_Send(NULL, 0, MPI_BYTE, s->peer, 9, s->comm);
+
+	s->time = timerElapsed(start, timerNow());
+
+	return NULL;
+}
+
+/*
+ * Role d'un rank dans le test de latence sous charge : les 2n premiers ranks testes forment les n paires sondes (le i-eme avec
+ * le n+i-eme), les suivants les paires de charge, formees comme la bissection (le i-eme de la premiere moitie avec le i-eme de
+ * la seconde). Renvoie LOADED_PROBE, LOADED_BULK, ou 0 pour le MASTER et le dernier noeud si ils sont en nombre impair.
+ */
+int loadedRole(int rank, int nbNodes, int* peer, int* role, Options* o) {
+	int n = o->loaded, first = 2 * o->loaded + 1, m = (nbNodes - first) / 2;
+
+	if(rank >= 1 && rank < first) {
+		*role = (rank <= n) ? SENDER : RECVER;
+		*peer = (rank <= n) ? rank + n : rank - n;
+
+		return LOADED_PROBE;
+	}
+
+	if(rank >= first && rank < first + 2 * m) {
+		*role = (rank < first + m) ? SENDER : RECVER;
+		*peer = (rank < first + m) ? rank + m : rank - m;
+
+		return LOADED_BULK;
+	}
+
+	return 0;
+}
+
+/*
+ * Mode latence sous charge (option -L) : les paires sondes mesurent la distribution de la latence d'un mot vide, d'abord sur un
+ * reseau au repos, puis pendant que les paires de charge s'envoient des mots de pktSize octets sans arret. La fin de la charge
+ * est donnee par une barriere non bloquante : tous les autres noeuds y entrent au debut de la phase, les sondes quand elles ont
+ * fini, et les envoyeurs de charge s'arretent des qu'elle est passee. Chaque envoyeur renvoie au MASTER ses medianes et P99
+ * (sondes) ou son debit (charge).
+ */
+void loadedAllTests(int rank, int nbNodes, char* hostnames, Options* o) {
+	float results[4] = { -1, -1, -1, -1 }, *allResults = NULL;
+	MPI_Request stop;
+	int kind, peer = -1, role = DEACTIVATED, phase;
+	Histo h;
+
+	kind = loadedRole(rank, nbNodes, &peer, &role, o);
+
+	if(rank == MASTER && (allResults = (float*) malloc(sizeof(float) * 4 * nbNodes)) == NULL) {
+		fprintf(stderr, "ERROR: Can't allocate memory.");
+		exit(1);
+	}
+
+	/* Phase 0 au repos, phase 1 sous charge */
+	for(phase = 0; phase < 2; phase++) {
+		MPI_Barrier(MPI_COMM_WORLD);
+
+		if(phase == 1 && kind != LOADED_PROBE)
+			MPI_Ibarrier(MPI_COMM_WORLD, &stop);
+
+		if(kind == LOADED_PROBE) {
+			loadedProbe(peer, role, &h, o);
+
+			if(role == SENDER) {
+				results[2 * phase] = histoPercentile(&h, 0.5);
+				results[2 * phase + 1] = histoPercentile(&h, 0.99);
+			}
+
+			if(phase == 1)
+				MPI_Ibarrier(MPI_COMM_WORLD, &stop);
+
+		} else if(kind == LOADED_BULK && phase == 1)
+			results[0] = loadedBulk(peer, role, &stop, o);
+
+		if(phase == 1)
+			MPI_Wait(&stop, MPI_STATUS_IGNORE);
+	}
+
+	MPI_Gather(results, 4, MPI_FLOAT, allResults, 4, MPI_FLOAT, MASTER, MPI_COMM_WORLD);
+
+	if(rank == MASTER) {
+		if(o->yaml)
+			loadedToYAML(allResults, hostnames, nbNodes, o->yamlFile, o);
+
+		displayLoaded(allResults, hostnames, nbNodes, o);
+		free(allResults);
+	}
+}
+
+/*
+ * Sonde : LOADED_PINGS x nbRetry aller-retours d'un mot vide (apres l'echauffement), dont les latences (moitie de l'aller-retour)
+ * remplissent l'histogramme h de l'envoyeur.
+ */
+void loadedProbe(int peer, int role, Histo* h, Options* o) {
+	double start;
+	int i;
+
+	histoInit(h);
+
+	for(i = 0; i < o->warmup + LOADED_PINGS * o->nbRetry; i++) {
+		if(role == SENDER) {
+			start = timerNow();
+			MPI_Send(buffer, 0, MPI_BYTE, peer, 11, MPI_COMM_WORLD);
+			MPI_Recv(buffer, 0, MPI_BYTE, peer, 11, MPI_COMM_WORLD, &status);
+
+			if(i >= o->warmup)
+				histoAdd(h, timerElapsed(start, timerNow()) / 2 * 1e6);
+		} else {
+			MPI_Recv(buffer, 0, MPI_BYTE, peer, 11, MPI_COMM_WORLD, &status);
+			MPI_Send(buffer, 0, MPI_BYTE, peer, 11, MPI_COMM_WORLD);
+		}
+	}
+}
+
+/*
+ * Charge : l'envoyeur envoie des mots de pktSize octets jusqu'a ce que la barriere stop soit passee, puis un mot vide d'une autre
+ * etiquette qui arrete son receveur. Renvoie le debit de l'envoyeur pendant toute la charge (en Mo/s).
+ */
+float loadedBulk(int peer, int role, MPI_Request* stop, Options* o) {
+	double start = timerNow(), bytes = 0;
+	int done = 0;
+
+	if(role == RECVER) {
+		do {
+			MPI_Recv(buffer, o->pktSize, MPI_BYTE, peer, MPI_ANY_TAG, MPI_COMM_WORLD, &status);
+		} while(status.MPI_TAG == 12);
+
+		return -1;
+	}
+
+	while(!done) {
+		MPI_Send(buffer, o->pktSize, MPI_BYTE, peer, 12, MPI_COMM_WORLD);
+		bytes += o->pktSize;
+		MPI_Test(stop, &done, MPI_STATUS_IGNORE);
+	}
+
+	MPI_Send(buffer, 0, MPI_BYTE, peer, 13, MPI_COMM_WORLD);
+
+	return bytes / timerElapsed(start, timerNow()) / pow(1024, 2);
+}
+
+/*
+ * Mode collectives (option -C) : chaque operation collective est repetee pour chaque taille du balayage, sur un communicateur
+ * des seuls noeuds testes (sans le MASTER). Chaque repetition part d'une barriere, et chaque rank chronometre le temps qu'il
+ * passe dans l'operation. Il note aussi la date de son entree dans l'operation, ramenee sur l'horloge du MASTER avec le decalage
+ * estime au debut (voir clockStart) : l'etalement de ces dates mesure le decalage des arrivees, que la barriere n'efface pas
+ * tout a fait. Les durees moyennes et les dates d'entree de chaque rank sont recueillies par le MASTER a la fin, qui corrige
+ * les dates de la derive des horloges mesuree apres les tests (voir clockEnd).
+ */
+void collAllTests(int rank, int nbNodes, char* hostnames, Clocks* c, Options* o) {
+	MPI_Comm workers;
+	int nbTimes = COLL_NB_OPS * o->nbSizes, nbEntries = nbTimes * o->nbRetry, maxSize = o->sizes[o->nbSizes-1], op, k, i;
+	float *times, *allTimes = NULL;
+	double *entries, *allEntries = NULL;
+	char *sendBuf, *recvBuf;
+	double start;
+
+	times = (float*) malloc(sizeof(float) * nbTimes);
+	entries = (double*) malloc(sizeof(double) * nbEntries);
+
+	if(rank == MASTER) {
+		allTimes = (float*) malloc(sizeof(float) * nbTimes * nbNodes);
+		allEntries = (double*) malloc(sizeof(double) * nbEntries * nbNodes);
+	}
+
+	if(times == NULL || entries == NULL || (rank == MASTER && (allTimes == NULL || allEntries == NULL))) {
+		fprintf(stderr, "ERROR: Can't allocate memory.");
+		exit(1);
+	}
+
+	for(i = 0; i < nbTimes; times[i++] = -1);
+	for(i = 0; i < nbEntries; entries[i++] = 0);
+
+	MPI_Comm_split(MPI_COMM_WORLD, rank == MASTER ? MPI_UNDEFINED : 0, rank, &workers);
+
+	if(rank != MASTER) {
+
+		/* Alltoall et Allgather echangent un mot avec chacun des nbNodes - 1 noeuds testes */
+		sendBuf = (char*) calloc((size_t) maxSize * (nbNodes - 1), 1);
+		recvBuf = (char*) calloc((size_t) maxSize * (nbNodes - 1), 1);
+
+		if(sendBuf == NULL || recvBuf == NULL) {
+			fprintf(stderr, "ERROR: Can't allocate memory.");
+			exit(1);
+		}
+
+		for(op = 0; op < COLL_NB_OPS; op++) {
+
+			/* La barriere n'a pas de taille : elle n'est testee qu'une fois */
+			for(k = 0; k < (op == COLL_BARRIER ? 1 : o->nbSizes); k++) {
+				times[op * o->nbSizes + k] = 0;
+
+				for(i = 0; i < o->warmup + o->nbRetry; i++) {
+					MPI_Barrier(workers);
+					start = timerNow();
+					collOp(op, o->sizes[k], sendBuf, recvBuf, workers);
+
+					if(i >= o->warmup) {
+						times[op * o->nbSizes + k] += timerElapsed(start, timerNow()) * 1e6;
+						entries[(op * o->nbSizes + k) * o->nbRetry + i - o->warmup] = start - clockOffset[rank] - clockOrigin;
+					}
+				}
+
+				times[op * o->nbSizes + k] /= o->nbRetry;
+			}
+		}
+
+		free(sendBuf);
+		free(recvBuf);
+		MPI_Comm_free(&workers);
+	}
+
+	MPI_Gather(times, nbTimes, MPI_FLOAT, allTimes, nbTimes, MPI_FLOAT, MASTER, MPI_COMM_WORLD);
+	MPI_Gather(entries, nbEntries, MPI_DOUBLE, allEntries, nbEntries, MPI_DOUBLE, MASTER, MPI_COMM_WORLD);
+	clockEnd(rank, nbNodes, c);
+
+	if(rank == MASTER) {
+
+		/* A sa date d'entree, le decalage du rank a varie de sa derive depuis la premiere estimation (voir clockCorrect) */
+		for(k = 1; k < nbNodes; k++) {
+			for(i = 0; i < nbEntries; i++)
+				allEntries[k * nbEntries + i] -= c->drift[k] * (allEntries[k * nbEntries + i] - c->at[k]);
+		}
+
+		if(o->yaml)
+			collToYAML(allTimes, allEntries, hostnames, nbNodes, o->yamlFile, o);
+
+		displayColl(allTimes, allEntries, hostnames, nbNodes, o);
+		free(allTimes);
+		free(allEntries);
+	}
+
+	free(times);
+	free(entries);
+}
+
+/*
+ * Balayage par defaut des collectives : de 8 octets a la taille des mots de debit, en multipliant par 8.
+ */
+void collDefaultSizes(Options* o) {
+	int size;
+
+	for(o->nbSizes = 1, size = 8; size < o->pktSize; size *= 8, o->nbSizes++);
+
+	o->sizes = (int*) malloc(sizeof(int) * o->nbSizes);
+
+	if(o->sizes == NULL) {
+		fprintf(stderr, "ERROR: Can't allocate memory.");
+		exit(1);
+	}
+
+	for(o->nbSizes = 0, size = 8; size < o->pktSize; size *= 8)
+		o->sizes[o->nbSizes++] = size;
+
+	o->sizes[o->nbSizes++] = o->pktSize;
+}
+
+/*
+ * Une operation collective de size octets (par noeud pour Allgather et Alltoall) sur le communicateur des noeuds testes, depuis
+ * son premier rank pour Bcast et Reduce. Les reductions portent sur des flottants (MPI_SUM n'est pas defini sur MPI_BYTE).
+ */
+void collOp(int op, int size, char* sendBuf, char* recvBuf, MPI_Comm workers) {
+	int count = (size >= (int) sizeof(float)) ? size / sizeof(float) : 1;
+
+	switch(op) {
+		case COLL_BCAST :
+			MPI_Bcast(sendBuf, size, MPI_BYTE, 0, workers);
+		break;
+
+		case COLL_REDUCE :
+			MPI_Reduce(sendBuf, recvBuf, count, MPI_FLOAT, MPI_SUM, 0, workers);
+		break;
+
+		case COLL_ALLREDUCE :
+			MPI_Allreduce(sendBuf, recvBuf, count, MPI_FLOAT, MPI_SUM, workers);
+		break;
+
+		case COLL_ALLGATHER :
+			MPI_Allgather(sendBuf, size, MPI_BYTE, recvBuf, size, MPI_BYTE, workers);
+		break;
+
+		case COLL_ALLTOALL :
+			MPI_Alltoall(sendBuf, size, MPI_BYTE, recvBuf, size, MPI_BYTE, workers);
+		break;
+
+		default :
+			MPI_Barrier(workers);
+	}
+}
+
+/*
+ * Resume de l'operation op pour la k-ieme taille, a partir des durees moyennes et des dates d'entree de tous les ranks testes
+ * (voir CollStats). Pour chaque repetition, chaque rank est en retard sur le premier arrive : le decalage des arrivees est
+ * l'etalement moyen des dates d'entree, et le rank arrive le dernier celui dont le retard moyen est le plus grand.
+ */
+void collStatsOf(float* times, double* entries, int op, int k, int nbNodes, CollStats* s, Options* o) {
+	int nbEntries = COLL_NB_OPS * o->nbSizes * o->nbRetry, index = (op * o->nbSizes + k) * o->nbRetry, rank, i;
+	double *lag, first, last, entry;
+	float t;
+
+	lag = (double*) calloc(nbNodes, sizeof(double));
+
+	if(lag == NULL) {
+		fprintf(stderr, "ERROR: Can't allocate memory.");
+		exit(1);
+	}
+
+	s->slowest = 1;
+	s->max = s->avg = times[COLL_NB_OPS * o->nbSizes + op * o->nbSizes + k];
+
+	for(rank = 2; rank < nbNodes; rank++) {
+		t = times[rank * COLL_NB_OPS * o->nbSizes + op * o->nbSizes + k];
+		s->avg += t;
+
+		if(t > s->max) {
+			s->max = t;
+			s->slowest = rank;
+		}
+	}
+
+	s->avg /= nbNodes - 1;
+	s->skew = 0;
+
+	for(i = 0; i < o->nbRetry; i++) {
+		first = last = entries[nbEntries + index + i];
+
+		for(rank = 2; rank < nbNodes; rank++) {
+			entry = entries[rank * nbEntries + index + i];
+
+			if(entry < first)
+				first = entry;
+
+			if(entry > last)
+				last = entry;
+		}
+
+		s->skew += last - first;
+
+		for(rank = 1; rank < nbNodes; rank++)
+			lag[rank] += entries[rank * nbEntries + index + i] - first;
+	}
+
+	s->skew = s->skew / o->nbRetry * 1e6;
+	s->last = 1;
+
+	for(rank = 2; rank < nbNodes; rank++) {
+		if(lag[rank] > lag[s->last])
+			s->last = rank;
+	}
+
+	free(lag);
+}
+
+/*
+ * Mode surveillance (option -m) : dans une seule execution, un tour de la matrice concurrente distribuee est teste toutes les T
+ * secondes (toute la matrice est donc couverte en rrNbRounds tours). Le MASTER garde les derniers resultats de chaque lien
+ * dans un anneau, signale les liens dont la latence ou le debit s'eloigne trop de la mediane de leurs resultats precedents, et
+ * reecrit le fichier des metriques a chaque tour.
+ */
+void monitorAllTests(int rank, int nbNodes, char* hostnames, Topology* topo, Options* o) {
+	YourTest *tests, t;
+	Bench *benchs, *all, r;
+	Histo latencyHisto, flowHisto;
+	Monitor m;
+	float* series;
+	double start;
+	int period, i, n, maxSamples, timedOut, done;
+
+	maxSamples = (o->target > 0 && o->maxRetry > o->nbRetry) ? o->maxRetry : o->nbRetry;
+
+	tests = (YourTest*) malloc(sizeof(YourTest) * nbNodes);
+	benchs = (Bench*) malloc(sizeof(Bench) * maxSamples);
+	all = (Bench*) malloc(sizeof(Bench) * nbNodes);
+	series = (float*) malloc(sizeof(float) * (2 * o->nbSizes + 1));
+
+	if(tests == NULL || benchs == NULL || all == NULL || series == NULL) {
+		fprintf(stderr, "ERROR: Can't allocate memory.");
+		exit(1);
+	}
+
+	if(rank == MASTER)
+		monitorInit(&m, nbNodes, hostnames);
+
+	start = MPI_Wtime();
+
+	for(period = 0; o->monitorCount == 0 || period < o->monitorCount; period++) {
+		monitorTick(period, start, rank, o);
+
+		distPrepareRoundTests(tests, topo->nbPlayers, period % rrNbRounds(topo->nbPlayers), o->seed);
+		topoMapTests(tests, topo, o);
+		t = tests[rank];
+		formatTestsResult(&r, &t, rank);
+
+		/* Date limite du test du tour (option -e) : un lien bloque ne coute qu'un tour a la surveillance */
+		testStart(&t, o);
+		timedOut = done = 0;
+
+		/* Memes repetitions que pour la matrice concurrente, departs synchro compris */
+		for(i = 0; nextTest(&t, i, t.role == SENDER ? !timedOut && moreTests(benchs, i, o) : 0, o); i++) {
+			n = (i < o->warmup) ? 0 : i - o->warmup;
+			bissLaunchAllTests();
+
+			if(timedOut)
+				continue;
+
+			if(t.role == SENDER) {
+				if(benchTests(&t, &benchs[n], series, o))
+					done = i + 1;
+				else
+					timedOut = 1;
+			} else if(t.role == RECVER && !responsesToTests(&t, o))
+				timedOut = 1;
+		}
+
+		/* Seules les repetitions achevees avant le delai comptent ; un lien sans aucune garde ses champs a -1 */
+		n = (done < o->warmup) ? 0 : done - o->warmup;
+
+		if(t.role == SENDER && n > 0)
+			benchsSummary(benchs, n, &r, &latencyHisto, &flowHisto);
+		else if(t.role == SENDER)
+			r.samples = 0;
+
+		if(t.role == SENDER && o->timeout > 0)
+			r.timedOut = timedOut;
+
+		bissTransmitAllResults(all, &r);
+
+		if(rank == MASTER) {
+			m.period = period;
+
+			for(i = 1; i < nbNodes; i++) {
+				if(all[i].latency != -1)
+					monitorStore(&m, &all[i], o);
+			}
+
+			displayMonitor(&m, all);
+			monitorToFile(&m, all, o);
+		}
+	}
+
+	if(rank == MASTER)
+		monitorFree(&m);
+
+	free(tests);
+	free(benchs);
+	free(all);
+	free(series);
+}
+
+/*
+ * Allocation des anneaux des latences et des debits de chaque lien, vides au depart.
+ */
+void monitorInit(Monitor* m, int nbNodes, char* hostnames) {
+	int nbLinks = nbNodes * nbNodes;
+
+	m->nbNodes = nbNodes;
+	m->hostnames = hostnames;
+	m->period = 0;
+	m->count = (int*) calloc(nbLinks, sizeof(int));
+	m->drift = (int*) calloc(nbLinks, sizeof(int));
+	m->latency = (float*) malloc(sizeof(float) * nbLinks * MONITOR_RING);
+	m->flow = (float*) malloc(sizeof(float) * nbLinks * MONITOR_RING);
+	m->latencyBase = (float*) malloc(sizeof(float) * nbLinks);
+	m->flowBase = (float*) malloc(sizeof(float) * nbLinks);
+
+	if(m->count == NULL || m->drift == NULL || m->latency == NULL || m->flow == NULL || m->latencyBase == NULL || m->flowBase == NULL) {
+		fprintf(stderr, "ERROR: Can't allocate memory.");
+		exit(1);
+	}
+}
+
+void monitorFree(Monitor* m) {
+	free(m->count);
+	free(m->drift);
+	free(m->latency);
+	free(m->flow);
+	free(m->latencyBase);
+	free(m->flowBase);
+}
+
+/*
+ * Depart synchro d'un tour de surveillance, T secondes apres le precedent. Les noeuds l'attendent en dormant par petits pas
+ * (MONITOR_POLL_MS) plutot qu'en scrutant le reseau sans arret, comme le ferait un MPI_Bcast bloquant. Le numero du tour est
+ * diffuse : un message vide peut se terminer sur les noeuds sans attendre le MASTER, et les tours deriveraient alors d'un noeud a
+ * l'autre (un test sous -e partirait avant son partenaire).
+ */
+void monitorTick(int period, double start, int rank, Options* o) {
+	struct timespec pause;
+	MPI_Request request;
+	double wait;
+	int done = 0;
+
+	if(rank == MASTER) {
+		wait = start + period * o->monitor - MPI_Wtime();
+
+		if(wait > 0) {
+			pause.tv_sec = (time_t) wait;
+			pause.tv_nsec = (long) ((wait - pause.tv_sec) * 1e9);
+			nanosleep(&pause, NULL);
+		}
+	}
+
+	MPI_Ibcast(&period, 1, MPI_INT, MASTER, MPI_COMM_WORLD, &request);
+
+	pause.tv_sec = 0;
+	pause.tv_nsec = MONITOR_POLL_MS * 1000000L;
+
+	for(MPI_Test(&request, &done, MPI_STATUS_IGNORE); !done; MPI_Test(&request, &done, MPI_STATUS_IGNORE))
+		nanosleep(&pause, NULL);
+}
+
+/*
+ * Ajout du resultat d'un lien dans ses anneaux. La reference du lien est la mediane de ses resultats precedents encore dans
+ * l'anneau (au moins MONITOR_MIN_BASELINE) : le lien derive si la latence ou le debit s'en eloigne de plus de o->drift pourcents.
+ */
+void monitorStore(Monitor* m, Bench* b, Options* o) {
+	int link = b->sender * m->nbNodes + b->recver, slot = m->count[link] % MONITOR_RING;
+
+	m->latencyBase[link] = monitorBaseline(&m->latency[link * MONITOR_RING], m->count[link]);
+	m->flowBase[link] = monitorBaseline(&m->flow[link * MONITOR_RING], m->count[link]);
+
+	m->latency[link * MONITOR_RING + slot] = b->latency;
+	m->flow[link * MONITOR_RING + slot] = b->flow;
+	m->count[link]++;
+
+	m->drift[link] = 0;
+
+	if(m->latencyBase[link] > 0 && fabs(b->latency - m->latencyBase[link]) * 100 > o->drift * m->latencyBase[link])
+		m->drift[link] |= MONITOR_DRIFT_LATENCY;
+
+	if(m->flowBase[link] > 0 && fabs(b->flow - m->flowBase[link]) * 100 > o->drift * m->flowBase[link])
+		m->drift[link] |= MONITOR_DRIFT_FLOW;
+}
+
+/*
+ * Mediane des valeurs d'un anneau qui en a recu count, ou -1 si il n'en a pas encore assez pour servir de reference.
+ */
+float monitorBaseline(float* ring, int count) {
+	float sorted[MONITOR_RING];
+	int nb = (count < MONITOR_RING) ? count : MONITOR_RING;
+
+	if(nb < MONITOR_MIN_BASELINE)
+		return -1;
+
+	memcpy(sorted, ring, sizeof(float) * nb);
+	qsort(sorted, nb, sizeof(float), compareFloats);
+
+	return sorted[nb / 2];
+}
+
+/*
+ * Affichage du tour de surveillance qui vient de finir : nombre de liens testes, puis les liens qui derivent et ceux hors delai.
+ */
+void displayMonitor(Monitor* m, Bench* all) {
+	int i, link, nb = 0, nbDrifts = 0;
+
+	for(i = 1; i < m->nbNodes; i++) {
+		if(all[i].latency == -1)
+			continue;
+
+		link = all[i].sender * m->nbNodes + all[i].recver;
+		nb++;
+
+		if(m->drift[link])
+			nbDrifts++;
+	}
+
+	printf("Period %d : %d links tested, %d drifting\n", m->period, nb, nbDrifts);
+
+	for(i = 1; i < m->nbNodes; i++) {
+		if(all[i].latency == -1)
+			continue;
+
+		link = all[i].sender * m->nbNodes + all[i].recver;
+
+		if(m->drift[link]) {
+			printf("Drift : From %s (%d) to %s (%d) \tlatency %.3f us (baseline %.3f us) \tflow %.3f Mo/s (baseline %.3f Mo/s)\n",
+				rankToHostname(m->hostnames, all[i].sender), all[i].sender, rankToHostname(m->hostnames, all[i].recver), all[i].recver,
+				all[i].latency, m->latencyBase[link], all[i].flow, m->flowBase[link]);
+		}
+	}
+
+	/* Liens dont le test du tour a depasse son delai (option -e) */
+	for(i = 1; i < m->nbNodes; i++) {
+		if(all[i].timedOut == 1) {
+			printf("Timeout : From %s (%d) to %s (%d) \t%.0f samples kept\n", rankToHostname(m->hostnames, all[i].sender),
+				all[i].sender, rankToHostname(m->hostnames, all[i].recver), all[i].recver, all[i].samples);
+		}
+	}
+
+	fflush(stdout);
+}
+
+/*
+ * Ecriture des metriques du tour (option -M). Un fichier en .prom est reecrit en entier au format texte de Prometheus (dernier
+ * resultat de chaque lien deja teste), en passant par un fichier temporaire pour ne jamais etre lu a moitie ecrit. Sinon, une
+ * ligne JSON par lien teste pendant ce tour est ajoutee en fin de fichier.
+ */
+void monitorToFile(Monitor* m, Bench* all, Options* o) {
+	char* tmpFile;
+	size_t len;
+	FILE* f;
+	int i;
+
+	if(!o->metrics)
+		return;
+
+	len = strlen(o->metricsFile);
+
+	if(len > 5 && strcmp(o->metricsFile + len - 5, ".prom") == 0) {
+		tmpFile = (char*) malloc(len + 5);
+
+		if(tmpFile == NULL) {
+			fprintf(stderr, "ERROR: Can't allocate memory.");
+			exit(1);
+		}
+
+		sprintf(tmpFile, "%s.tmp", o->metricsFile);
+		f = fopen(tmpFile, "w");
+
+		if(f == NULL) {
+			fprintf(stderr, "ERROR: Can't write the metrics file.");
+			free(tmpFile);
+			return;
+		}
+
+		monitorToPrometheus(f, m);
+		fclose(f);
+		rename(tmpFile, o->metricsFile);
+		free(tmpFile);
+
+		return;
+	}
+
+	f = fopen(o->metricsFile, "a");
+
+	if(f == NULL) {
+		fprintf(stderr, "ERROR: Can't write the metrics file.");
+		return;
+	}
+
+	for(i = 1; i < m->nbNodes; i++) {
+		if(all[i].latency != -1)
+			monitorToJSONLine(f, m, &all[i]);
+	}
+
+	fclose(f);
+}
+
+/*
+ * Metriques de tous les liens deja testes, au format texte de Prometheus (une jauge par valeur, le lien en etiquettes).
+ */
+void monitorToPrometheus(FILE* f, Monitor* m) {
+	const char* names[5] = {"bwlat_latency_us", "bwlat_flow_mbps", "bwlat_latency_baseline_us", "bwlat_flow_baseline_mbps", "bwlat_drift"};
+	const char* helps[5] = {"Median latency of the last test of the link.", "Median flow of the last test of the link.",
+		"Median latency of the previous tests of the link (-1 until enough tests).",
+		"Median flow of the previous tests of the link (-1 until enough tests).",
+		"Drift of the last test from the baseline (1 latency, 2 flow, 3 both)."};
+	int metric, sender, recver, link, slot;
+	float value;
+
+	fprintf(f, "# HELP bwlat_period Last monitoring period.\n# TYPE bwlat_period gauge\nbwlat_period %d\n", m->period);
+
+	for(metric = 0; metric < 5; metric++) {
+		fprintf(f, "# HELP %s %s\n# TYPE %s gauge\n", names[metric], helps[metric], names[metric]);
+
+		for(sender = 1; sender < m->nbNodes; sender++) {
+			for(recver = 1; recver < m->nbNodes; recver++) {
+				link = sender * m->nbNodes + recver;
+
+				if(m->count[link] == 0)
+					continue;
+
+				slot = (m->count[link] - 1) % MONITOR_RING;
+
+				switch(metric) {
+					case 0 : value = m->latency[link * MONITOR_RING + slot]; break;
+					case 1 : value = m->flow[link * MONITOR_RING + slot]; break;
+					case 2 : value = m->latencyBase[link]; break;
+					case 3 : value = m->flowBase[link]; break;
+					default : value = m->drift[link];
+				}
+
+				fprintf(f, "%s{sender=\"%s\",sender_rank=\"%d\",recver=\"%s\",recver_rank=\"%d\"} %.3f\n", names[metric],
+					rankToHostname(m->hostnames, sender), sender, rankToHostname(m->hostnames, recver), recver, value);
+			}
+		}
+	}
+}
+
+/*
+ * Ligne JSON du resultat d'un lien pendant le tour courant.
+ */
+void monitorToJSONLine(FILE* f, Monitor* m, Bench* b) {
+	int link = b->sender * m->nbNodes + b->recver;
+
+	fprintf(f, "{\"period\": %d, \"time\": %ld, \"sender\": %d, \"recver\": %d, \"sender_host\": \"%s\", \"recver_host\": \"%s\", "
+		"\"latency\": %.3f, \"flow\": %.3f, \"latency_baseline\": %.3f, \"flow_baseline\": %.3f, \"drift\": %d}\n",
+		m->period, (long) time(NULL), b->sender, b->recver, rankToHostname(m->hostnames, b->sender),
+		rankToHostname(m->hostnames, b->recver), b->latency, b->flow, m->latencyBase[link], m->flowBase[link], m->drift[link]);
+}
+
+/*
+ * Fonction collective d'envoi du test associe a chaque rank, depuis le MASTER.
+ */
+void bissTransmitAllTests(YourTest* bissTests, YourTest* t) {
+	MPI_Scatter(bissTests, 1, TestType, t, 1, TestType, MASTER, MPI_COMM_WORLD);
+}
+
+/*
+ * Fonction collective d'envoi d'un broadcast vide, permettant de lancer un depart synchro des tests de bissections.
+ */
+void bissLaunchAllTests() {
+	MPI_Bcast(buffer, 0, MPI_BYTE, MASTER, MPI_COMM_WORLD);
+}
+
+/*
+ * Fonction collectice d'envoi des resultats de la part de chaque rank vers le MASTER.
+ */
+void bissTransmitAllResults(Bench* bissResults, Bench* r) {
+	MPI_Gather(r, 1, BenchType, bissResults, 1, BenchType, MASTER, MPI_COMM_WORLD);
+}
+
+/*
+ * Fonction collective d'envoi des courbes du balayage de chaque rank vers le MASTER (a appeler juste apres bissTransmitAllResults).
+ */
+void bissTransmitAllSweeps(float* bissSweeps, float* series, Options* o) {
+	MPI_Gather(series, 2 * o->nbSizes, MPI_FLOAT, bissSweeps, 2 * o->nbSizes, MPI_FLOAT, MASTER, MPI_COMM_WORLD);
+}
+
+/*
+ * Rangement des courbes des envoyeurs d'une bissection (ou d'un tour) dans la matrice des courbes.
+ */
+void bissStoreAllSweeps(float* sweep, float* bissSweeps, Bench* rBiss, int nbNodes, Options* o) {
+	int i;
+
+	for(i = 1; i < nbNodes; i++) {
+		if(rBiss[i].latency != -1)
+			memcpy(sweepOf(sweep, i, rBiss[i].recver, nbNodes, o), &bissSweeps[i * 2 * o->nbSizes], sizeof(float) * 2 * o->nbSizes);
+	}
+}
+
+/*
+ * Envoi de la courbe du balayage au MASTER, de la part de l'envoyeur (juste apres sendResults).
+ */
+void sendSweep(float* series, Options* o) {
+	MPI_Send(series, 2 * o->nbSizes, MPI_FLOAT, MASTER, 0, MPI_COMM_WORLD);
+}
+
+/*
+ * Reception de la courbe du balayage de l'envoyeur qui vient de realiser son test (pour le rank 0).
+ */
+void receiveSweep(float* series, int sender, Options* o) {
+	MPI_Recv(series, 2 * o->nbSizes, MPI_FLOAT, sender, 0, MPI_COMM_WORLD, &status);
+}
+
+/*
+ * Courbe d'une paire dans la matrice des courbes : nbSizes latences, suivies de nbSizes debits.
+ */
+float* sweepOf(float* sweep, int sender, int recver, int nbNodes, Options* o) {
+	return &sweep[(sender * nbNodes + recver) * 2 * o->nbSizes];
+}
+
+/*
+ * Taille n1/2 d'une courbe : taille de message a partir de laquelle la moitie du debit maximum de la courbe est atteinte,
+ * par interpolation lineaire entre les deux tailles qui l'encadrent.
+ */
+float sweepNHalf(float* series, Options* o) {
+	int k;
+	float half, *flows = &series[o->nbSizes];
+
+	for(half = 0, k = 0; k < o->nbSizes; k++) {
+		if(flows[k] > half)
+			half = flows[k];
+	}
+
+	half /= 2;
+
+	for(k = 0; k < o->nbSizes; k++) {
+		if(flows[k] >= half) {
+			if(k == 0)
+				return o->sizes[0];
+
+			return o->sizes[k-1] + (o->sizes[k] - o->sizes[k-1]) * (half - flows[k-1]) / (flows[k] - flows[k-1]);
+		}
+	}
+
+	return o->sizes[o->nbSizes-1];
+}
+
+/* Fonction permettant la conversion numero de rank vers Hostname, dans la table des hostnames. */
+char* rankToHostname(char* hostnames, int rank) {
+	return &hostnames[rank * HOSTNAME_SIZE];
+}
+
+/*
+ * Affichage des resultats sous forme de tableau texte non-parsable.
+ */
+void displayTab(Results* r, Options* o) {
+	int x, y, k, nbNodes = r->nbNodes;
+	Bench b;
+
+	/* Affichage des resultats de la bissections (ou du mode echantillonne) sous forme d'un tableau simple dont la premier
+	colonne indique l'envoyeur et la seconde le receveur avec la latence et le debit calculees */
+	if(o->bissection || r->nbPartners > 0) {
+
+		/* Pour chaque envoyeur et ses receveurs : seules les paires testees ont une latence differente de -1 */
+		for(y = 1; y < nbNodes; y++) {
+			for(k = 0; k < resultNbRecvers(r); k++) {
+				x = resultRecver(r, y, k);
+
+				if(!resultTested(r, y, x))
+					continue;
+
+				loadResult(r, y, x, &b);
+
+				puts("+---------------------+----------------------+");
+				printf("| From %-15s", rankToHostname(r->hostnames, y));
+				printf("| To %-17s |\n", rankToHostname(r->hostnames, x));
+				printf("|                     ");
+				printf("| %17.3f us |\n", b.latency);
+				printf("|                     ");
+				printf("| %15.3f Mo/s |\n", b.flow);
+
+				/* Debit en flux continu, juste sous le debit NWS */
+				if(o->window > 0) {
+					printf("|              stream ");
+					printf("| %15.3f Mo/s |\n", b.streamFlow);
+				}
+
+				/* Nombre de repetitions retenues, variable en mode adaptatif */
+				if(o->target > 0) {
+					printf("|             samples ");
+					printf("| %20.0f |\n", b.samples);
+				}
+
+				/* Debits bidirectionnels : agrege, puis chacun des deux sens */
+				if(o->bidir) {
+					printf("|           bidir sum ");
+					printf("| %15.3f Mo/s |\n", b.bidirFlow);
+					printf("|            bidir -> ");
+					printf("| %15.3f Mo/s |\n", b.bidirOut);
+					printf("|            bidir <- ");
+					printf("| %15.3f Mo/s |\n", b.bidirIn);
+				}
+
+				/* Debit verifie et nombre de mots corrompus */
+				if(o->integrity) {
+					printf("|            verified ");
+					printf("| %15.3f Mo/s |\n", b.verifiedFlow);
+					printf("|           corrupted ");
+					printf("| %20.0f |\n", b.corrupted);
+				}
+
+				/* Operations RMA : latence et debit de Put, puis de Get */
+				if(o->rma != RMA_NONE) {
+					printf("|             put lat ");
+					printf("| %17.3f us |\n", b.putLatency);
+					printf("|            put flow ");
+					printf("| %15.3f Mo/s |\n", b.putFlow);
+					printf("|             get lat ");
+					printf("| %17.3f us |\n", b.getLatency);
+					printf("|            get flow ");
+					printf("| %15.3f Mo/s |\n", b.getFlow);
+				}
+
+				/* Latence dans chaque sens */
+				if(o->oneWay) {
+					printf("|             1way -> ");
+					printf("| %17.3f us |\n", b.oneWayOut);
+					printf("|             1way <- ");
+					printf("| %17.3f us |\n", b.oneWayIn);
+				}
+			}
+		}
+
+		puts("+---------------------+----------------------+");
+
+	/* Affichage des resultats sous forme d'une matrice equilibree de tous les noeuds, avec la debit et la latence pour chaque
+	paire de noeud possible, dans les deux sens */
+	} else {
+
+		/* Premiere ligne de tirets */
+		printf("                       ");
+		for(x = 1; x < nbNodes; printf("+----------------------"), x++);
+		printf("+\n                       ");
+
+		/* Lignes des entetes de colonnes (receveurs) */
+		for(x = 1; x < nbNodes; printf("| To %-17s ", rankToHostname(r->hostnames, x++)));
+		printf("|\n");
+
+		/* Ligne de tirets de separation */
+		for(x = 0; x < nbNodes; printf("+----------------------"), x++);
+		puts("+");
+
+		/* Pour chaque ligne/envoyeur */
+		for(y = 1; y < nbNodes; y++) {
+
+			/* Entete */
+			printf("| From %-15s ", rankToHostname(r->hostnames, y));
+
+			/* Latence, ou suite de tirets si on est l'envoyeur correspond au receveur */
+			for(x = 1; x < nbNodes; x++) {
+				(x == y) ?
+					printf("|----------------------") :
+					printf("| %17.3f us ", RESULT(r, offsetof(Bench, latency), y, x));
+			}
+
+			printf("|\n|                      ");
+
+			/* Debit, ou suite de tirets si on est l'envoyeur correspond au receveur */
+			for(x = 1; x < nbNodes; x++) {
+				(x == y) ?
+					printf("|----------------------") :
+					printf("| %15.3f Mo/s ", RESULT(r, offsetof(Bench, flow), y, x));
+			}
+
+			/* Debit en flux continu, juste sous le debit NWS */
+			if(o->window > 0)
+				displayTabLine(r, y, "stream", offsetof(Bench, streamFlow));
+
+			/* Nombre de repetitions retenues, variable en mode adaptatif */
+			if(o->target > 0) {
+				printf("|\n|              samples ");
+
+				for(x = 1; x < nbNodes; x++) {
+					(x == y) ?
+						printf("|----------------------") :
+						printf("| %20.0f ", RESULT(r, offsetof(Bench, samples), y, x));
+				}
+			}
+
+			/* Debits bidirectionnels : agrege, puis chacun des deux sens */
+			if(o->bidir) {
+				displayTabLine(r, y, "bidir sum", offsetof(Bench, bidirFlow));
+				displayTabLine(r, y, "bidir ->", offsetof(Bench, bidirOut));
+				displayTabLine(r, y, "bidir <-", offsetof(Bench, bidirIn));
+			}
+
+			/* Debit verifie et nombre de mots corrompus */
+			if(o->integrity) {
+				displayTabLine(r, y, "verified", offsetof(Bench, verifiedFlow));
+				printf("|\n|            corrupted ");
+
+				for(x = 1; x < nbNodes; x++) {
+					(x == y) ?
+						printf("|----------------------") :
+						printf("| %20.0f ", RESULT(r, offsetof(Bench, corrupted), y, x));
+				}
+			}
+
+			/* Operations RMA : latence et debit de Put, puis de Get */
+			if(o->rma != RMA_NONE) {
+				displayTabLatencyLine(r, y, "put lat", offsetof(Bench, putLatency));
+				displayTabLine(r, y, "put flow", offsetof(Bench, putFlow));
+				displayTabLatencyLine(r, y, "get lat", offsetof(Bench, getLatency));
+				displayTabLine(r, y, "get flow", offsetof(Bench, getFlow));
+			}
+
+			/* Latence dans chaque sens */
+			if(o->oneWay) {
+				displayTabLatencyLine(r, y, "1way ->", offsetof(Bench, oneWayOut));
+				displayTabLatencyLine(r, y, "1way <-", offsetof(Bench, oneWayIn));
+			}
+
+			/* Fermeture de ligne */
+			puts("|");
+			for(x = 1; x < nbNodes+1; printf("+----------------------"), x++);
+			puts("+");
+		}
+	}
+}
+/*
+ * Affichage des courbes du balayage des tailles sous forme de tableaux texte non-parsables, un par paire testee.
+ */
+void displaySweep(Results* r, float* sweep, Options* o) {
+	int x, y, k, nbNodes = r->nbNodes;
+	float* series;
+	char size[16];
+
+	for(y = 1; y < nbNodes; y++) {
+		for(x = 1; x < nbNodes; x++) {
+			series = sweepOf(sweep, y, x, nbNodes, o);
+
+			if(y == x || series[0] == -1)
+				continue;
+
+			/* Entete : la paire et sa taille n1/2 */
+			formatSize(size, (int) sweepNHalf(series, o));
+
+			puts("\n+----------------------+----------------------+----------------------+");
+			printf("| From %-15s ", rankToHostname(r->hostnames, y));
+			printf("| To %-17s ", rankToHostname(r->hostnames, x));
+			printf("| n1/2 %13s B |\n", size);
+			puts("+----------------------+----------------------+----------------------+");
+
+			/* Un point de la courbe par ligne */
+			for(k = 0; k < o->nbSizes; k++) {
+				formatSize(size, o->sizes[k]);
+				printf("| %18s B ", size);
+				printf("| %17.3f us ", series[k]);
+				printf("| %15.3f Mo/s |\n", series[o->nbSizes + k]);
+			}
+
+			puts("+----------------------+----------------------+----------------------+");
+		}
+	}
+}
+
+/*
+ * Affichage des statistiques du balayage des tailles : une ligne par taille, avec les latences et debits min, moyens et max.
+ */
+void displaySweepStats(SweepStats* s, Options* o) {
+	int k;
+	char size[16], nHalfMin[16], nHalfAvg[16], nHalfMax[16];
+
+	puts("\nSweep :");
+	printf("%10s | %12s | %12s | %12s | %15s | %15s | %15s\n", "Size", "Lat min (us)", "Lat avg (us)", "Lat max (us)", "Flow min (Mo/s)", "Flow avg (Mo/s)", "Flow max (Mo/s)");
+
+	for(k = 0; k < o->nbSizes; k++) {
+		formatSize(size, o->sizes[k]);
+		printf(
+			"%10s | %12.3f | %12.3f | %12.3f | %15.3f | %15.3f | %15.3f\n",
+			size,
+			s->points[k].latencyMin, s->points[k].latencyAvg, s->points[k].latencyMax,
+			s->points[k].flowMin, s->points[k].flowAvg, s->points[k].flowMax
+		);
+	}
+
+	formatSize(nHalfMin, (int) s->nHalfMin);
+	formatSize(nHalfAvg, (int) s->nHalfAvg);
+	formatSize(nHalfMax, (int) s->nHalfMax);
+	printf("n1/2 : Min %s B \tAvg %s B \tMax %s B\n", nHalfMin, nHalfAvg, nHalfMax);
+}
+
+/*
+ * Affichage des resultats du test incast/outcast : une ligne par palier et par sens, avec les debits min, moyen et max des
+ * transferts, le debit agrege et l'indice d'equite de Jain.
+ */
+void displayFan(float* flows, char* hostname, Options* o) {
+	int step, dir, k, p;
+	float *f, min, max, sum;
+
+	printf("\nIncast (K to %s) / outcast (%s to K) :\n", hostname, hostname);
+	printf("%4s | %7s | %15s | %15s | %15s | %16s | %6s\n", "K", "", "Flow min (Mo/s)", "Flow avg (Mo/s)", "Flow max (Mo/s)", "Aggregate (Mo/s)", "Jain");
+
+	for(step = 0; step < fanNbSteps(o); step++) {
+		k = fanPeers(step, o);
+
+		for(dir = 0; dir < 2; dir++) {
+			f = fanOf(flows, step, dir, o);
+			min = max = sum = f[0];
+
+			for(p = 1; p < k; p++) {
+				sum += f[p];
+
+				if(f[p] < min)
+					min = f[p];
+
+				if(f[p] > max)
+					max = f[p];
+			}
+
+			printf(
+				"%4d | %7s | %15.3f | %15.3f | %15.3f | %16.3f | %6.3f\n",
+				k, dir == 0 ? "incast" : "outcast", min, sum / k, max, fanAggregate(f, k), jainIndex(f, k)
+			);
+		}
+	}
+}
+
+/*
+ * Affichage d'une ligne supplementaire de debits dans la matrice (displayTab), pour l'envoyeur y et un champ des Bench.
+ */
+void displayTabLine(Results* r, int y, char* title, size_t field) {
+	int x;
+
+	printf("|\n| %20s ", title);
+
+	for(x = 1; x < r->nbNodes; x++) {
+		(x == y) ?
+			printf("|----------------------") :
+			printf("| %15.3f Mo/s ", RESULT(r, field, y, x));
+	}
+}
+
+/*
+ * Idem pour une ligne de latences.
+ */
+void displayTabLatencyLine(Results* r, int y, char* title, size_t field) {
+	int x;
+
+	printf("|\n| %20s ", title);
+
+	for(x = 1; x < r->nbNodes; x++) {
+		(x == y) ?
+			printf("|----------------------") :
+			printf("| %17.3f us ", RESULT(r, field, y, x));
+	}
+}
+
+/* 
+ * Affichage des statistiques en relation avec la matrice ou la bissection sous forme de texte non-parsable.
+ * Latence min et max ainsi que debit min et max.
+ * Ainsi que les sommes et les moyennes.
+ */
+void displayStats(Results* r, StatsResult* latencyStats, StatsResult* flowStats) {
+	displayFieldStats(r, latencyStats, offsetof(Bench, latency), "Latency", "us");
+
+	/* Distribution de toutes les repetitions de toutes les paires */
+	displayHisto(&latencyStats->histo, "us");
+
+	displayFieldStats(r, flowStats, offsetof(Bench, flow), "Flow", "Mo/s");
+	displayHisto(&flowStats->histo, "Mo/s");
+}
+
+/*
+ * Ecriture en YAML dans un fichier des resultats.
+ */
+void toYAML(Results* r, float* sweep, char* yamlFile, Options* o) {
+	FILE* yaml;
+	int x, y, k, nbNodes = r->nbNodes;
+	char policy[64], timerInfo[128];
+	Bench b;
+
+	yaml = fopen(yamlFile, "w");
+
+	if(yaml == NULL) {
+		fprintf(stderr, "ERROR: Can't write the yaml file.");
+		return;
+	}
+
+	/* Politique des buffers et synchronisation RMA de tous les resultats, en commentaires pour ne pas changer la structure */
+	bufferPolicyName(policy, o);
+	timerDescribe(timerInfo);
+	fprintf(yaml, "# buffer : %s\n# timer : %s\n", policy, timerInfo);
+
+	if(o->rma != RMA_NONE)
+		fprintf(yaml, "# rma : %s\n", rmaSyncName(o));
+
+	if(r->clocks != NULL)
+		clocksToYAML(yaml, r->clocks, r->hostnames, nbNodes);
+
+	if(r->nbPartners > 0)
+		sampleHostsToYAML(yaml, r);
+
+	if(o->timeout > 0)
+		timeoutsToYAML(yaml, r);
+
+	/* Export du tableau des resultats (meme structure que pour la matrice), avec les seules paires testees */
+	if(o->bissection || r->nbPartners > 0) {
+
+		/* Pour chaque envoyeur et ses receveurs */
+		for(y = 1; y < nbNodes; y++) {
+			for(x = -1, k = 0; k < resultNbRecvers(r); k++) {
+				if(!resultTested(r, y, resultRecver(r, y, k)))
+					continue;
+
+				/* L'envoyeur n'est ecrit qu'avant son premier receveur */
+				if(x == -1)
+					fprintf(yaml, "%s :\n", rankToHostname(r->hostnames, y));
+
+				x = resultRecver(r, y, k);
+				loadResult(r, y, x, &b);
+
+				fprintf(yaml, "  %s :\n", rankToHostname(r->hostnames, x));
+				fprintf(yaml, "    latency : %.3f\n", b.latency);
+				fprintf(yaml, "    flow : %.3f\n", b.flow);
+				fprintf(yaml, "    samples : %.0f\n", b.samples);
+				fprintf(yaml, "    distribution :\n");
+				distToYAML(yaml, "latency", &b, offsetof(Bench, latency), offsetof(Bench, latencyMin));
+				distToYAML(yaml, "flow", &b, offsetof(Bench, flow), offsetof(Bench, flowMin));
+
+				if(o->window > 0)
+					fprintf(yaml, "    stream : %.3f\n", b.streamFlow);
+
+				if(o->bidir)
+					bidirToYAML(yaml, &b);
+
+				if(o->integrity)
+					integrityToYAML(yaml, &b);
+
+				if(o->rma != RMA_NONE)
+					rmaToYAML(yaml, &b);
+
+				if(o->oneWay)
+					oneWayToYAML(yaml, &b);
+
+				if(o->nbSizes > 0)
+					sweepToYAML(yaml, sweepOf(sweep, y, x, nbNodes, o), o);
+			}
+		}
+
+	/* Export de la matrice des resultats (3 niveaux : envoyeur => receveur => debit/latence) */
+	} else {
+
+		/* Pour chaque envoyeur */
+		for(y = 1; y < nbNodes; y++) {
+			fprintf(yaml, "%s :\n", rankToHostname(r->hostnames, y));
+
+			/* Pour chaque receveur */
+			for(x = 1; x < nbNodes; x++) {
+				if(y != x) {
+					loadResult(r, y, x, &b);
+
+					fprintf(yaml, "  %s :\n", rankToHostname(r->hostnames, x));
+					fprintf(yaml, "    latency : %.3f\n", b.latency);
+					fprintf(yaml, "    flow : %.3f\n", b.flow);
+					fprintf(yaml, "    samples : %.0f\n", b.samples);
+					fprintf(yaml, "    distribution :\n");
+					distToYAML(yaml, "latency", &b, offsetof(Bench, latency), offsetof(Bench, latencyMin));
+					distToYAML(yaml, "flow", &b, offsetof(Bench, flow), offsetof(Bench, flowMin));
+
+					if(o->window > 0)
+						fprintf(yaml, "    stream : %.3f\n", b.streamFlow);
+
+					if(o->bidir)
+						bidirToYAML(yaml, &b);
+
+					if(o->integrity)
+						integrityToYAML(yaml, &b);
+
+					if(o->rma != RMA_NONE)
+						rmaToYAML(yaml, &b);
+
+					if(o->oneWay)
+						oneWayToYAML(yaml, &b);
+
+					if(o->nbSizes > 0)
+						sweepToYAML(yaml, sweepOf(sweep, y, x, nbNodes, o), o);
+				}
+			}
+		}
+	}
+
+	fclose(yaml);
+}
+
+/*
+ * Ecriture en YAML des resultats du test incast/outcast : sous le nom du noeud central, pour chaque palier K et chaque sens, le
+ * debit de chaque transfert (dans l'ordre des ranks des K noeuds), le debit agrege et l'indice de Jain.
+ */
+void fanToYAML(float* flows, char* hostname, char* yamlFile, Options* o) {
+	FILE* yaml;
+	int step, dir, k, p;
+	char policy[64], timerInfo[128];
+	float* f;
+
+	yaml = fopen(yamlFile, "w");
+
+	if(yaml == NULL) {
+		fprintf(stderr, "ERROR: Can't write the yaml file.");
+		return;
+	}
+
+	bufferPolicyName(policy, o);
+	timerDescribe(timerInfo);
+	fprintf(yaml, "# buffer : %s\n# timer : %s\n---\n%s :\n", policy, timerInfo, hostname);
+
+	for(step = 0; step < fanNbSteps(o); step++) {
+		k = fanPeers(step, o);
+		fprintf(yaml, "  %d :\n", k);
+
+		for(dir = 0; dir < 2; dir++) {
+			f = fanOf(flows, step, dir, o);
+			fprintf(yaml, "    %s :\n      flows : [", dir == 0 ? "incast" : "outcast");
+
+			for(p = 0; p < k; p++)
+				fprintf(yaml, "%s%.3f", p ? ", " : "", f[p]);
+
+			fprintf(yaml, "]\n      aggregate : %.3f\n      jain : %.3f\n", fanAggregate(f, k), jainIndex(f, k));
+		}
+	}
+
+	fclose(yaml);
+}
+
+/*
+ * Affichage du test multi threads : pour chaque paire et chaque nombre de threads, les debits min, moyen et max des threads,
+ * le debit agrege de la paire (voir fanAggregate), son rapport au debit avec un seul thread et l'indice d'equite de Jain.
  */
-void createTestType() {
-	MPI_Type_extent(MPI_INT, &extentType);
+void displayThreads(float* flows, char* hostnames, int nbNodes, Options* o) {
+	int half = (nbNodes - 1) / 2, nbFlows = threadsNbSteps(o) * o->threads, sender, step, k, t;
+	float *f, min, max, sum, single;
+	char pair[2 * HOSTNAME_SIZE + 32];
+
+	printf("\nMulti-threaded flows (Mo/s) :\n");
+	printf("%-32s | %4s | %15s | %15s | %15s | %16s | %7s | %6s\n", "Pair", "T", "Thread min", "Thread avg", "Thread max", "Aggregate", "Scaling", "Jain");
+
+	for(sender = 1; sender <= half; sender++) {
+		sprintf(pair, "%s (%d) -> %s (%d)", rankToHostname(hostnames, sender), sender, rankToHostname(hostnames, sender + half), sender + half);
+		single = flows[sender * nbFlows];
+
+		for(step = 0; step < threadsNbSteps(o); step++) {
+			k = threadsOf(step, o);
+			f = &flows[sender * nbFlows + step * o->threads];
+			min = max = sum = f[0];
+
+			for(t = 1; t < k; t++) {
+				sum += f[t];
+
+				if(f[t] < min)
+					min = f[t];
+
+				if(f[t] > max)
+					max = f[t];
+			}
+
+			printf(
+				"%-32s | %4d | %15.3f | %15.3f | %15.3f | %16.3f | %7.2f | %6.3f\n",
+				step == 0 ? pair : "", k, min, sum / k, max, fanAggregate(f, k), fanAggregate(f, k) / single, jainIndex(f, k)
+			);
+		}
+	}
+}
+
+/*
+ * Ecriture en YAML du test multi threads : envoyeur => receveur => nombre de threads => debits de chaque thread et agrege.
+ */
+void threadsToYAML(float* flows, char* hostnames, int nbNodes, char* yamlFile, Options* o) {
+	FILE* yaml;
+	int half = (nbNodes - 1) / 2, nbFlows = threadsNbSteps(o) * o->threads, sender, step, k, t;
+	char timerInfo[128];
+	float* f;
+
+	yaml = fopen(yamlFile, "w");
+
+	if(yaml == NULL) {
+		fprintf(stderr, "ERROR: Can't write the yaml file.");
+		return;
+	}
+
+	timerDescribe(timerInfo);
+	fprintf(yaml, "# timer : %s\n---\n", timerInfo);
+
+	for(sender = 1; sender <= half; sender++) {
+		fprintf(yaml, "%s :\n  %s :\n", rankToHostname(hostnames, sender), rankToHostname(hostnames, sender + half));
+
+		for(step = 0; step < threadsNbSteps(o); step++) {
+			k = threadsOf(step, o);
+			f = &flows[sender * nbFlows + step * o->threads];
+			fprintf(yaml, "    %d :\n      flows : [", k);
+
+			for(t = 0; t < k; t++)
+				fprintf(yaml, "%s%.3f", t ? ", " : "", f[t]);
+
+			fprintf(yaml, "]\n      aggregate : %.3f\n      jain : %.3f\n", fanAggregate(f, k), jainIndex(f, k));
+		}
+	}
+
+	fclose(yaml);
+}
+
+/*
+ * Affichage du test de latence sous charge : pour chaque lien sonde, mediane et P99 des latences au repos puis sous charge, et
+ * leurs facteurs d'inflation (sous charge / au repos). Suivent les debits de chaque paire de charge.
+ */
+void displayLoaded(float* results, char* hostnames, int nbNodes, Options* o) {
+	int sender, peer, role;
+	char pair[2 * HOSTNAME_SIZE + 32];
+	float* r;
+
+	printf("\nLoaded latency (us) :\n");
+	printf("%-32s | %12s | %12s | %12s | %12s | %14s | %14s\n", "Probe link", "Idle P50", "Idle P99", "Loaded P50", "Loaded P99", "Inflation P50", "Inflation P99");
+
+	for(sender = 1; sender < nbNodes; sender++) {
+		if(loadedRole(sender, nbNodes, &peer, &role, o) != LOADED_PROBE || role != SENDER)
+			continue;
+
+		r = &results[4 * sender];
+		sprintf(pair, "%s (%d) -> %s (%d)", rankToHostname(hostnames, sender), sender, rankToHostname(hostnames, peer), peer);
+		printf("%-32s | %12.3f | %12.3f | %12.3f | %12.3f | %14.2f | %14.2f\n", pair, r[0], r[1], r[2], r[3], r[2] / r[0], r[3] / r[1]);
+	}
+
+	printf("\nBulk flows (Mo/s, messages of %d bytes) :\n", o->pktSize);
+
+	for(sender = 1; sender < nbNodes; sender++) {
+		if(loadedRole(sender, nbNodes, &peer, &role, o) != LOADED_BULK || role != SENDER)
+			continue;
+
+		sprintf(pair, "%s (%d) -> %s (%d)", rankToHostname(hostnames, sender), sender, rankToHostname(hostnames, peer), peer);
+		printf("%-32s | %15.3f\n", pair, results[4 * sender]);
+	}
+}
+
+/*
+ * Ecriture en YAML du test de latence sous charge : envoyeur => receveur => latences au repos et sous charge et inflation pour
+ * les sondes, debit pour la charge.
+ */
+void loadedToYAML(float* results, char* hostnames, int nbNodes, char* yamlFile, Options* o) {
+	FILE* yaml;
+	int sender, peer, role, kind;
+	char timerInfo[128];
+	float* r;
+
+	yaml = fopen(yamlFile, "w");
+
+	if(yaml == NULL) {
+		fprintf(stderr, "ERROR: Can't write the yaml file.");
+		return;
+	}
+
+	timerDescribe(timerInfo);
+	fprintf(yaml, "# timer : %s\n---\n", timerInfo);
+
+	for(sender = 1; sender < nbNodes; sender++) {
+		kind = loadedRole(sender, nbNodes, &peer, &role, o);
+
+		if(kind == 0 || role != SENDER)
+			continue;
+
+		r = &results[4 * sender];
+		fprintf(yaml, "%s :\n  %s :\n", rankToHostname(hostnames, sender), rankToHostname(hostnames, peer));
+
+		if(kind == LOADED_BULK) {
+			fprintf(yaml, "    bulk_flow : %.3f\n", r[0]);
+			continue;
+		}
+
+		fprintf(yaml, "    idle : { p50 : %.3f, p99 : %.3f }\n", r[0], r[1]);
+		fprintf(yaml, "    loaded : { p50 : %.3f, p99 : %.3f }\n", r[2], r[3]);
+		fprintf(yaml, "    inflation : { p50 : %.3f, p99 : %.3f }\n", r[2] / r[0], r[3] / r[1]);
+	}
+
+	fclose(yaml);
+}
+
+/*
+ * Affichage des operations collectives : pour chaque operation et chaque taille, la duree du rank le plus lent, la moyenne des
+ * ranks, le decalage des arrivees, puis le rank le plus lent et le rank arrive le dernier (voir collStatsOf). Un rank lent qui
+ * arrive a l'heure est ralenti dans l'operation elle meme (son reseau), un rank qui arrive le dernier fait attendre les autres.
+ */
+void displayColl(float* times, double* entries, char* hostnames, int nbNodes, Options* o) {
+	CollStats s;
+	char size[16], slowest[HOSTNAME_SIZE + 16], last[HOSTNAME_SIZE + 16];
+	int op, k;
+
+	printf("\nCollectives (%d nodes, us) :\n", nbNodes - 1);
+	printf("%-9s | %6s | %15s | %15s | %15s | %-24s | %s\n", "Operation", "Size", "Time (slowest)", "Time (avg)", "Arrival skew", "Slowest rank", "Last arrived rank");
+
+	for(op = 0; op < COLL_NB_OPS; op++) {
+		for(k = 0; k < (op == COLL_BARRIER ? 1 : o->nbSizes); k++) {
+			collStatsOf(times, entries, op, k, nbNodes, &s, o);
+			formatSize(size, o->sizes[k]);
+			sprintf(slowest, "%s (%d)", rankToHostname(hostnames, s.slowest), s.slowest);
+			sprintf(last, "%s (%d)", rankToHostname(hostnames, s.last), s.last);
+
+			printf(
+				"%-9s | %6s | %15.3f | %15.3f | %15.3f | %-24s | %s\n",
+				collNames[op], op == COLL_BARRIER ? "-" : size, s.max, s.avg, s.skew, slowest, last
+			);
+		}
+	}
+}
+
+/*
+ * Ecriture en YAML des operations collectives : operation => taille => resume et duree moyenne de chaque rank.
+ */
+void collToYAML(float* times, double* entries, char* hostnames, int nbNodes, char* yamlFile, Options* o) {
+	FILE* yaml;
+	CollStats s;
+	int op, k, rank;
+	char timerInfo[128];
+
+	yaml = fopen(yamlFile, "w");
+
+	if(yaml == NULL) {
+		fprintf(stderr, "ERROR: Can't write the yaml file.");
+		return;
+	}
+
+	timerDescribe(timerInfo);
+	fprintf(yaml, "# timer : %s\n---\ncollectives :\n", timerInfo);
+
+	for(op = 0; op < COLL_NB_OPS; op++) {
+		fprintf(yaml, "  %s :\n", collNames[op]);
+
+		for(k = 0; k < (op == COLL_BARRIER ? 1 : o->nbSizes); k++) {
+			collStatsOf(times, entries, op, k, nbNodes, &s, o);
+			fprintf(yaml, "    %d :\n", op == COLL_BARRIER ? 0 : o->sizes[k]);
+			fprintf(yaml, "      slowest_time : %.3f\n      avg_time : %.3f\n      skew : %.3f\n", s.max, s.avg, s.skew);
+			fprintf(yaml, "      slowest : %s\n      last : %s\n      ranks : [", rankToHostname(hostnames, s.slowest), rankToHostname(hostnames, s.last));
+
+			for(rank = 1; rank < nbNodes; rank++)
+				fprintf(yaml, "%s%.3f", rank > 1 ? ", " : "", times[rank * COLL_NB_OPS * o->nbSizes + op * o->nbSizes + k]);
+
+			fprintf(yaml, "]\n");
+		}
+	}
+
+	fclose(yaml);
+}
+
+/*
+ * Ecriture en YAML des tests RMA d'une paire (latence et debit de Put et de Get).
+ */
+void rmaToYAML(FILE* yaml, Bench* b) {
+	fprintf(yaml, "    rma :\n");
+	fprintf(yaml, "      put :\n");
+	fprintf(yaml, "        latency : %.3f\n", b->putLatency);
+	fprintf(yaml, "        flow : %.3f\n", b->putFlow);
+	fprintf(yaml, "      get :\n");
+	fprintf(yaml, "        latency : %.3f\n", b->getLatency);
+	fprintf(yaml, "        flow : %.3f\n", b->getFlow);
+}
+
+/*
+ * Ecriture en YAML des latences dans chaque sens d'une paire.
+ */
+void oneWayToYAML(FILE* yaml, Bench* b) {
+	fprintf(yaml, "    oneway :\n");
+	fprintf(yaml, "      out : %.3f\n", b->oneWayOut);
+	fprintf(yaml, "      in : %.3f\n", b->oneWayIn);
+}
+
+/*
+ * Horloges de tous les ranks en commentaires du YAML (une ligne par rank), pour ne pas changer la structure envoyeur => receveur.
+ */
+void clocksToYAML(FILE* yaml, Clocks* c, char* hostnames, int nbNodes) {
+	int rank;
+
+	for(rank = 1; rank < nbNodes; rank++) {
+		fprintf(
+			yaml, "# clock : %s (%d) : { offset : %.3f, error : %.3f, drift : %.3f }\n",
+			rankToHostname(hostnames, rank), rank, c->offset[rank] * 1e6, c->error[rank] * 1e6, c->drift[rank] * 1e6
+		);
+	}
+}
+
+/*
+ * Affichage des horloges de tous les ranks : decalage par rapport au MASTER et son incertitude en us, derive en us par seconde
+ * (ppm).
+ */
+void displayClocks(Clocks* c, char* hostnames, int nbNodes) {
+	int rank;
+
+	printf("\nClocks (offset to the master %s) :\n", rankToHostname(hostnames, MASTER));
+	printf("%-24s | %6s | %15s | %15s | %12s\n", "Host", "Rank", "Offset (us)", "Error (us)", "Drift (ppm)");
+
+	for(rank = 1; rank < nbNodes; rank++) {
+		printf(
+			"%-24s | %6d | %15.3f | %15.3f | %12.3f\n",
+			rankToHostname(hostnames, rank), rank, c->offset[rank] * 1e6, c->error[rank] * 1e6, c->drift[rank] * 1e6
+		);
+	}
+}
+
+/*
+ * Sommes des latences et debits des liens echantillonnes par machine (indexees par leur leader) : chaque lien compte pour la
+ * machine de l'envoyeur et pour celle du receveur (une seule fois si c'est la meme). Un seul parcours des N x K liens.
+ */
+SampleHost* sampleHosts(Results* r) {
+	SampleHost* hosts = (SampleHost*) calloc(r->nbNodes, sizeof(SampleHost));
+	float latency, flow;
+	int i, j, k, h, n;
+
+	if(hosts == NULL) {
+		fprintf(stderr, "ERROR: Can't allocate memory.");
+		exit(1);
+	}
+
+	for(i = 1; i < r->nbNodes; i++) {
+		for(k = 0; k < resultNbRecvers(r); k++) {
+			j = resultRecver(r, i, k);
+
+			if(!resultTested(r, i, j))
+				continue;
+
+			latency = RESULT(r, offsetof(Bench, latency), i, j);
+			flow = RESULT(r, offsetof(Bench, flow), i, j);
+
+			for(n = 0; n < 2; n++) {
+				h = r->nodeOf[n ? j : i];
+
+				if(n && h == r->nodeOf[i])
+					break;
+
+				hosts[h].nb++;
+				hosts[h].latency += latency;
+				hosts[h].latencySq += latency * latency;
+				hosts[h].flow += flow;
+				hosts[h].flowSq += flow * flow;
+			}
+		}
+	}
+
+	return hosts;
+}
+
+/*
+ * Demi largeur de l'intervalle de confiance a 95% d'une moyenne de n valeurs d'ecart type stddev (quantile de Student approche
+ * comme dans welchSignificant), 0 si n < 2.
+ */
+float confidence95(float stddev, int n) {
+	double z = 1.96, df = n - 1;
+
+	if(n < 2)
+		return 0;
+
+	return (z + (pow(z, 3) + z) / (4 * df) + (5 * pow(z, 5) + 16 * pow(z, 3) + 3 * z) / (96 * df * df)) * stddev / sqrt(n);
+}
+
+/*
+ * Affichage des estimations par machine du mode echantillonne : nombre de liens, latence et debit moyens avec leur intervalle de
+ * confiance a 95%.
+ */
+void displaySampleHosts(Results* r) {
+	SampleHost* hosts = sampleHosts(r);
+	SampleHost* h;
+	int i;
+
+	printf("\nSampled hosts (%d partners per rank, 95%% confidence) :\n", r->nbPartners);
+	printf("%-24s | %6s | %27s | %31s\n", "Host", "Links", "Latency (us)", "Flow (Mo/s)");
+
+	for(i = 1; i < r->nbNodes; i++) {
+		h = &hosts[i];
+
+		if(r->nodeOf[i] != i || h->nb == 0)
+			continue;
+
+		printf(
+			"%-24s | %6d | %12.3f +/- %10.3f | %14.3f +/- %12.3f\n", rankToHostname(r->hostnames, i), h->nb,
+			h->latency / h->nb, confidence95(SAMPLE_STDDEV(h->latency, h->latencySq, h->nb), h->nb),
+			h->flow / h->nb, confidence95(SAMPLE_STDDEV(h->flow, h->flowSq, h->nb), h->nb)
+		);
+	}
+
+	free(hosts);
+}
+
+/*
+ * Ecriture des estimations par machine du mode echantillonne, en commentaires du YAML comme les horloges.
+ */
+void sampleHostsToYAML(FILE* yaml, Results* r) {
+	SampleHost* hosts = sampleHosts(r);
+	SampleHost* h;
+	int i;
+
+	fprintf(yaml, "# sampled : %d partners per rank\n", r->nbPartners);
+
+	for(i = 1; i < r->nbNodes; i++) {
+		h = &hosts[i];
+
+		if(r->nodeOf[i] != i || h->nb == 0)
+			continue;
+
+		fprintf(
+			yaml, "# host : %s : { links : %d, latency : %.3f, latency_ci95 : %.3f, flow : %.3f, flow_ci95 : %.3f }\n",
+			rankToHostname(r->hostnames, i), h->nb,
+			h->latency / h->nb, confidence95(SAMPLE_STDDEV(h->latency, h->latencySq, h->nb), h->nb),
+			h->flow / h->nb, confidence95(SAMPLE_STDDEV(h->flow, h->flowSq, h->nb), h->nb)
+		);
+	}
+
+	free(hosts);
+}
+
+/*
+ * Liens dont le test a depasse son delai (option -e), avec le nombre de repetitions achevees a temps qui restent dans les
+ * resultats. Renvoie le nombre de ces liens, listes si display est vrai.
+ */
+int timeoutsSummary(Results* r, Options* o, int display) {
+	int sender, recver, k, nb = 0;
+
+	for(sender = 1; sender < r->nbNodes; sender++) {
+		for(k = 0; k < resultNbRecvers(r); k++) {
+			recver = resultRecver(r, sender, k);
+
+			if(recver < 0 || RESULT(r, offsetof(Bench, timedOut), sender, recver) != 1)
+				continue;
+
+			if(++nb == 1 && display)
+				printf("\nTimed out links (%.3f s per test) :\n", o->timeout);
+
+			if(display) {
+				printf("From %s (%d) to %s (%d) \t%.0f samples kept\n", rankToHostname(r->hostnames, sender), sender,
+					rankToHostname(r->hostnames, recver), recver, RESULT(r, offsetof(Bench, samples), sender, recver));
+			}
+		}
+	}
+
+	if(display)
+		printf("\n%d links timed out\n", nb);
+
+	return nb;
+}
+
+/*
+ * Ecriture des liens hors delai (option -e), en commentaires du YAML comme les horloges : les liens sans repetition achevee
+ * n'apparaissent pas dans les resultats.
+ */
+void timeoutsToYAML(FILE* yaml, Results* r) {
+	int sender, recver, k;
+
+	for(sender = 1; sender < r->nbNodes; sender++) {
+		for(k = 0; k < resultNbRecvers(r); k++) {
+			recver = resultRecver(r, sender, k);
+
+			if(recver >= 0 && RESULT(r, offsetof(Bench, timedOut), sender, recver) == 1) {
+				fprintf(yaml, "# timeout : %s (%d) -> %s (%d) : { samples : %.0f }\n", rankToHostname(r->hostnames, sender), sender,
+					rankToHostname(r->hostnames, recver), recver, RESULT(r, offsetof(Bench, samples), sender, recver));
+			}
+		}
+	}
+}
+
+/*
+ * Ecriture en YAML du test d'integrite d'une paire (debit verifie et nombre de mots corrompus).
+ */
+void integrityToYAML(FILE* yaml, Bench* b) {
+	fprintf(yaml, "    integrity :\n");
+	fprintf(yaml, "      flow : %.3f\n", b->verifiedFlow);
+	fprintf(yaml, "      corrupted : %.0f\n", b->corrupted);
+}
+
+/*
+ * Ecriture en YAML des debits bidirectionnels d'une paire (agrege et par sens).
+ */
+void bidirToYAML(FILE* yaml, Bench* b) {
+	fprintf(yaml, "    bidir :\n");
+	fprintf(yaml, "      sum : %.3f\n", b->bidirFlow);
+	fprintf(yaml, "      out : %.3f\n", b->bidirOut);
+	fprintf(yaml, "      in : %.3f\n", b->bidirIn);
+}
+
+/*
+ * Ecriture en YAML de la courbe du balayage d'une paire, sous la forme d'une liste de points (taille, latence, debit).
+ */
+void sweepToYAML(FILE* yaml, float* series, Options* o) {
+	int k;
+
+	fprintf(yaml, "    nhalf : %.0f\n", sweepNHalf(series, o));
+	fprintf(yaml, "    sweep :\n");
+
+	for(k = 0; k < o->nbSizes; k++) {
+		fprintf(yaml, "      - size : %d\n", o->sizes[k]);
+		fprintf(yaml, "        latency : %.3f\n", series[k]);
+		fprintf(yaml, "        flow : %.3f\n", series[o->nbSizes + k]);
+	}
+}
+
+/*
+ * Comparaison des resultats avec ceux d'une execution precedente (option -R), lien par lien : ecarts de latence et de debit en
+ * pourcentage de l'ancienne valeur, regressions au dela du seuil o->threshold qui sont aussi significatives (voir
+ * welchSignificant), puis ecarts moyens par machine. Renvoie le nombre de regressions.
+ */
+int compareResults(Results* r, ResultsFile* baseline, Options* o) {
+	float *latencyDeltas, *flowDeltas, latencyDelta, flowDelta;
+	int *nbLinks, i, sender, recver, host, nb = 0, nbRegressions = 0, latencyWorse, flowWorse;
+	Bench old, cur;
+
+	latencyDeltas = (float*) calloc(r->nbNodes, sizeof(float));
+	flowDeltas = (float*) calloc(r->nbNodes, sizeof(float));
+	nbLinks = (int*) calloc(r->nbNodes, sizeof(int));
+
+	if(latencyDeltas == NULL || flowDeltas == NULL || nbLinks == NULL) {
+		fprintf(stderr, "ERROR: Can't allocate memory.");
+		exit(1);
+	}
+
+	printf("\nComparison with %s (threshold %.1f%%) :\n", o->baselineFile, o->threshold);
+
+	for(i = 0; i < baseline->nbRecords; i++) {
+		resultsFileGet(baseline, i, &old);
+		sender = compareRank(r, baseline, old.sender);
+		recver = compareRank(r, baseline, old.recver);
+
+		if(sender < 0 || recver < 0 || !resultTested(r, sender, recver) || old.latency <= 0 || old.flow <= 0)
+			continue;
+
+		loadResult(r, sender, recver, &cur);
+		nb++;
+
+		latencyDelta = (cur.latency - old.latency) * 100 / old.latency;
+		flowDelta = (cur.flow - old.flow) * 100 / old.flow;
+
+		/* Les ecarts s'ajoutent a ceux des deux machines du lien (designees par leur leader) */
+		for(host = r->nodeOf[sender]; ; host = r->nodeOf[recver]) {
+			latencyDeltas[host] += latencyDelta;
+			flowDeltas[host] += flowDelta;
+			nbLinks[host]++;
+
+			if(host == r->nodeOf[recver])
+				break;
+		}
+
+		latencyWorse = latencyDelta > o->threshold
+			&& welchSignificant(cur.latency, cur.latencyStddev, cur.samples, old.latency, old.latencyStddev, old.samples);
+		flowWorse = -flowDelta > o->threshold
+			&& welchSignificant(cur.flow, cur.flowStddev, cur.samples, old.flow, old.flowStddev, old.samples);
+
+		if(latencyWorse || flowWorse) {
+			nbRegressions++;
+			printf("Regression : From %s (%d) to %s (%d) \tlatency %.3f -> %.3f us (%+.1f%%) \tflow %.3f -> %.3f Mo/s (%+.1f%%)\n",
+				rankToHostname(r->hostnames, sender), sender, rankToHostname(r->hostnames, recver), recver,
+				old.latency, cur.latency, latencyDelta, old.flow, cur.flow, flowDelta);
+		}
+	}
+
+	printf("\nPer host deltas :\n");
+
+	for(host = 1; host < r->nbNodes; host++) {
+		if(nbLinks[host] > 0) {
+			printf("%s \tlatency %+.1f%% \tflow %+.1f%% \t(%d links)\n", rankToHostname(r->hostnames, host),
+				latencyDeltas[host] / nbLinks[host], flowDeltas[host] / nbLinks[host], nbLinks[host]);
+		}
+	}
+
+	printf("\n%d links compared, %d regressions\n", nb, nbRegressions);
+
+	free(latencyDeltas);
+	free(flowDeltas);
+	free(nbLinks);
+
+	return nbRegressions;
+}
+
+/*
+ * Rank de l'execution courante correspondant a un rank du fichier de reference : le meme si il est sur la meme machine, sinon
+ * le premier rank de cette machine (ordre des ranks different d'une execution a l'autre). -1 si la machine n'est plus testee.
+ */
+int compareRank(Results* r, ResultsFile* baseline, int rank) {
+	char* hostname = resultsFileHostname(baseline, rank);
+	int i;
+
+	if(rank < r->nbNodes && strcmp(rankToHostname(r->hostnames, rank), hostname) == 0)
+		return rank;
+
+	for(i = 1; i < r->nbNodes; i++) {
+		if(strcmp(rankToHostname(r->hostnames, i), hostname) == 0)
+			return i;
+	}
+
+	return -1;
+}
+
+/*
+ * Test de Welch : l'ecart entre deux valeurs (medianes, de n1 et n2 repetitions d'ecarts types s1 et s2) est il significatif a
+ * 95% ? La valeur critique de Student pour df degres de liberte est approchee par le developpement de Cornish-Fisher. Sans
+ * distribution connue (ancien fichier, une seule repetition), seul le seuil compte.
+ */
+int welchSignificant(float m1, float s1, float n1, float m2, float s2, float n2) {
+	double v1, v2, t, df, z = 1.96;
+
+	if(n1 < 2 || n2 < 2 || s1 < 0 || s2 < 0)
+		return 1;
+
+	v1 = s1 * s1 / n1;
+	v2 = s2 * s2 / n2;
+
+	if(v1 + v2 == 0)
+		return m1 != m2;
+
+	t = fabs(m1 - m2) / sqrt(v1 + v2);
+	df = (v1 + v2) * (v1 + v2) / (v1 * v1 / (n1 - 1) + v2 * v2 / (n2 - 1));
 
-	testTypeDisp[0] = 0;
-	testTypeDisp[1] = extentType;
+	return t > z + (pow(z, 3) + z) / (4 * df) + (5 * pow(z, 5) + 16 * pow(z, 3) + 3 * z) / (96 * df * df);
+}
 
-	MPI_Type_struct(2, testTypeBlocks, testTypeDisp, testTypeTypes, &TestType);
-	MPI_Type_commit(&TestType);
+/*
+ * Exporte la somme des debits constates sous forme de coordonnees (x: nb noeuds, y: somme).
+ * Sert pour la construction d'un graphique gnuplot du total des debits de bissections testees avec des nombres de noeuds
+ * variables, et dans le cadre d'un script plus global.
+ */
+void toGnuplot(StatsResult* flowStats, int nbNodes) {
+	printf("%d\t%.3f\n", nbNodes, flowStats->sum);
+}
+
+/*
+ * Fonction de calcul des statistiques (min, max, somme et moyenne) des latences et des debits de toutes les paires testees.
+ */
+void stats(Results* r, StatsResult* latencyStats, StatsResult* flowStats) {
+	fieldStats(r, latencyStats, offsetof(Bench, latency), TOPO_ALL);
+	fieldStats(r, flowStats, offsetof(Bench, flow), TOPO_ALL);
 }
 
 /*
- * Creation d'un type ResultType pour MPI qui permettra de faire transiter des structures MyResult d'un noeud a l'autre.
+ * Inference de l'arbre du reseau (option -I) : les machines sont regroupees par lien simple (single linkage) sur une distance
+ * qui combine latence et debit (voir inferDistances). L'algorithme de Kruskal fusionne les groupes par distance croissante ;
+ * chaque saut dans les hauteurs de fusion (de plus de INFER_GAP) separe deux niveaux de l'arbre, comme les machines d'un meme
+ * switch puis celles d'un meme pod. Le tri des N(N-1)/2 liens domine : O(N^2 log N) pour N machines.
  */
-void createResultType() {
-	MPI_Datatype resultTypeTypes[2] = { MPI_CHAR, BenchType };
-	MPI_Type_extent(MPI_CHAR, &extentType);
+void inferTopology(Results* r, char* inferFile, int display) {
+	InferEdge* edges;
+	Infer in;
+	FILE* f;
+	size_t len = strlen(inferFile);
+	int *members, nbEdges = 0, a, b, i;
+
+	in.hostnames = r->hostnames;
+	in.hosts = (int*) malloc(sizeof(int) * r->nbNodes);
+
+	if(in.hosts == NULL) {
+		fprintf(stderr, "ERROR: Can't allocate memory.");
+		exit(1);
+	}
+
+	for(in.nbHosts = 0, i = 1; i < r->nbNodes; i++) {
+		if(r->nodeOf[i] == i)
+			in.hosts[in.nbHosts++] = i;
+	}
+
+	inferDistances(r, &in);
+
+	edges = (InferEdge*) malloc(sizeof(InferEdge) * ((size_t) in.nbHosts * (in.nbHosts - 1) / 2 + 1));
+	members = (int*) malloc(sizeof(int) * in.nbHosts);
+
+	if(edges == NULL || members == NULL) {
+		fprintf(stderr, "ERROR: Can't allocate memory.");
+		exit(1);
+	}
+
+	for(a = 0; a < in.nbHosts; a++) {
+		members[a] = a;
+
+		for(b = a + 1; b < in.nbHosts; b++) {
+			if(in.d[a * in.nbHosts + b] >= 0) {
+				edges[nbEdges].d = in.d[a * in.nbHosts + b];
+				edges[nbEdges].a = a;
+				edges[nbEdges++].b = b;
+			}
+		}
+	}
+
+	qsort(edges, nbEdges, sizeof(InferEdge), compareEdges);
+	inferLevels(&in, edges, nbEdges);
+	inferMisfits(&in);
+
+	f = fopen(inferFile, "w");
+
+	if(f == NULL)
+		fprintf(stderr, "ERROR: Can't write the topology file.");
+
+	/* DOT : un graphe oriente de la racine vers les groupes, puis les machines (celles mal integrees en rouge) */
+	else if(len > 4 && strcmp(inferFile + len - 4, ".dot") == 0) {
+		fprintf(f, "digraph topology {\n");
+		inferEmit(f, 1, "root", in.nbLevels - 1, members, in.nbHosts, &in);
+
+		for(a = 0; a < in.nbHosts; a++) {
+			if(in.misfit[a])
+				fprintf(f, "  \"%s\" [color=red];\n", rankToHostname(in.hostnames, in.hosts[a]));
+		}
+
+		fprintf(f, "}\n");
+		fclose(f);
+
+	/* YAML : groupes imbriques, du plus haut niveau aux listes de machines, puis les machines mal integrees */
+	} else {
+		fprintf(f, "# levels :");
+
+		for(i = 0; i < in.nbLevels; i++)
+			fprintf(f, " %.3f", in.thresholds[i]);
+
+		fprintf(f, "\n---\ntopology :\n");
+		inferEmit(f, 0, NULL, in.nbLevels - 1, members, in.nbHosts, &in);
+		for(i = 0, a = 0; a < in.nbHosts; i += in.misfit[a], a++);
+
+		fprintf(f, "misfits :%s\n", i > 0 ? "" : " []");
+
+		for(a = 0; a < in.nbHosts; a++) {
+			if(in.misfit[a])
+				fprintf(f, "  - { host : %s, silhouette : %.3f }\n", rankToHostname(in.hostnames, in.hosts[a]), in.silhouette[a]);
+		}
 
-	resultTypeDisp[0] = 0;
-	resultTypeDisp[1] = extentType*100;
+		fclose(f);
+	}
 
-	MPI_Type_struct(2, resultTypeBlocks, resultTypeDisp, resultTypeTypes, &ResultType);
-	MPI_Type_commit(&ResultType);
+	if(display)
+		displayInfer(&in);
+
+	free(edges);
+	free(members);
+	free(in.hosts);
+	free(in.d);
+	free(in.labels);
+	free(in.thresholds);
+	free(in.silhouette);
+	free(in.misfit);
 }
 
 /*
- * Met en ecoute tous les autres noeuds que l'envoyeur designe, afin qu'ils soient prets a recevoir un test de celui-ci.
+ * Distance entre deux machines : moyenne des latences de tous les liens testes entre leurs ranks (dans les deux sens) divisee
+ * par la moyenne de toutes les machines, plus l'inverse pour le debit. Deux machines sous un meme switch sont a environ 2, et
+ * la distance croit avec la latence comme avec la perte de debit. Les liens internes aux machines sont ignores.
  */
-void prepareTests(int nbNodes, int sender) {
-	int i;
-	YourTest t;
+void inferDistances(Results* r, Infer* in) {
+	int *hostOf, *count, h = in->nbHosts, i, j, k, nb = 0;
+	float *latency, *flow, lat, fl;
+	double latencyRef = 0, flowRef = 0;
+
+	hostOf = (int*) malloc(sizeof(int) * r->nbNodes);
+	count = (int*) calloc((size_t) h * h, sizeof(int));
+	latency = (float*) calloc((size_t) h * h, sizeof(float));
+	flow = (float*) calloc((size_t) h * h, sizeof(float));
+	in->d = (float*) malloc(sizeof(float) * h * h);
+
+	if(hostOf == NULL || count == NULL || latency == NULL || flow == NULL || in->d == NULL) {
+		fprintf(stderr, "ERROR: Can't allocate memory.");
+		exit(1);
+	}
 
-	for(i = 1; i < nbNodes; i++) {
-		if(i != sender) {
-			t.role = RECVER;
-			t.withRank = sender;
+	for(k = 0; k < h; k++)
+		hostOf[in->hosts[k]] = k;
+
+	for(i = 1; i < r->nbNodes; i++) {
+		for(j = 1; j < r->nbNodes; j++) {
+			if(r->nodeOf[i] == r->nodeOf[j] || !resultTested(r, i, j) || RESULT(r, offsetof(Bench, flow), i, j) <= 0)
+				continue;
+
+			k = hostOf[r->nodeOf[i]] * h + hostOf[r->nodeOf[j]];
+			latency[k] += RESULT(r, offsetof(Bench, latency), i, j);
+			flow[k] += RESULT(r, offsetof(Bench, flow), i, j);
+			count[k]++;
+		}
+	}
+
+	/* Moyennes par paire de machines (les deux sens ensemble), puis references de toutes les paires */
+	for(i = 0; i < h; i++) {
+		for(j = i + 1; j < h; j++) {
+			k = count[i * h + j] + count[j * h + i];
+
+			if(k > 0) {
+				latency[i * h + j] = (latency[i * h + j] + latency[j * h + i]) / k;
+				flow[i * h + j] = (flow[i * h + j] + flow[j * h + i]) / k;
+				latencyRef += latency[i * h + j];
+				flowRef += flow[i * h + j];
+				nb++;
+			}
+
+			count[i * h + j] = k;
+		}
+	}
+
+	for(i = 0; i < h; i++) {
+		in->d[i * h + i] = 0;
 
-			MPI_Send(&t, 1, TestType, i, 0, MPI_COMM_WORLD);
+		for(j = i + 1; j < h; j++) {
+			lat = latency[i * h + j];
+			fl = flow[i * h + j];
+			in->d[i * h + j] = in->d[j * h + i] = (count[i * h + j] > 0 && lat > 0) ? lat * nb / latencyRef + flowRef / nb / fl : -1;
 		}
 	}
+
+	free(hostOf);
+	free(count);
+	free(latency);
+	free(flow);
 }
 
 /*
- * Envoi de son test a l'envoyeur pour lui indiquer de communiquer avec un des receveurs pret a receptionner un mot
- * de lui.
+ * Representant du groupe de la machine i (union-find, avec compression du chemin par moitie).
  */
-void launchTests(int sender, int recver) {
-	YourTest t;
+int inferFind(int* parent, int i) {
+	while(parent[i] != i) {
+		parent[i] = parent[parent[i]];
+		i = parent[i];
+	}
 
-	t.role = SENDER;
-	t.withRank = recver;
+	return i;
+}
 
-	MPI_Send(&t, 1, TestType, sender, 0, MPI_COMM_WORLD);
+int compareEdges(const void* a, const void* b) {
+	float x = ((const InferEdge*) a)->d, y = ((const InferEdge*) b)->d;
+
+	return (x > y) - (x < y);
 }
 
 /*
- * Par defaut, tous les noeuds attendent un test du MASTER.
+ * Niveaux de l'arbre : un premier passage de Kruskal releve les hauteurs des fusions (croissantes), et chaque saut de plus de
+ * INFER_GAP entre deux fusions successives fixe le seuil d'un niveau ; le dernier niveau reunit tout ce qui est relie. Un second
+ * passage note le groupe de chaque machine une fois toutes les fusions sous le seuil de chaque niveau faites.
  */
-void waitTests(YourTest* t) {
-	MPI_Recv(t, 1, TestType, MASTER, 0, MPI_COMM_WORLD, &status);
+void inferLevels(Infer* in, InferEdge* edges, int nbEdges) {
+	int *parent, h = in->nbHosts, nbMerges = 0, level, e, ra, rb, i;
+	float* heights;
+
+	parent = (int*) malloc(sizeof(int) * (h + 1));
+	heights = (float*) malloc(sizeof(float) * (h + 1));
+	in->thresholds = (float*) malloc(sizeof(float) * (h + 1));
+	in->labels = (int*) malloc(sizeof(int) * (h + 1) * (h + 1));
+
+	if(parent == NULL || heights == NULL || in->thresholds == NULL || in->labels == NULL) {
+		fprintf(stderr, "ERROR: Can't allocate memory.");
+		exit(1);
+	}
+
+	for(i = 0; i < h; parent[i] = i, i++);
+
+	for(e = 0; e < nbEdges; e++) {
+		ra = inferFind(parent, edges[e].a);
+		rb = inferFind(parent, edges[e].b);
+
+		if(ra != rb) {
+			parent[ra] = rb;
+			heights[nbMerges++] = edges[e].d;
+		}
+	}
+
+	in->nbLevels = 0;
+
+	for(i = 1; i < nbMerges; i++) {
+		if(heights[i] > INFER_GAP * heights[i-1])
+			in->thresholds[in->nbLevels++] = heights[i-1];
+	}
+
+	in->thresholds[in->nbLevels++] = (nbMerges > 0) ? heights[nbMerges-1] : 0;
+
+	for(i = 0; i < h; parent[i] = i, i++);
+
+	for(e = 0, level = 0; level < in->nbLevels; level++) {
+		for(; e < nbEdges && edges[e].d <= in->thresholds[level]; e++) {
+			ra = inferFind(parent, edges[e].a);
+			rb = inferFind(parent, edges[e].b);
+
+			if(ra != rb)
+				parent[ra] = rb;
+		}
+
+		for(i = 0; i < h; i++)
+			in->labels[level * h + i] = inferFind(parent, i);
+	}
+
+	free(parent);
+	free(heights);
 }
 
 /*
- * Envoi du resultat MyResult au MASTER, de la part de l'envoyeur.
+ * Machines mal integrees a leur groupe du premier niveau : seules dans leur groupe, ou de silhouette inferieure a INFER_MISFIT.
+ * La silhouette compare la distance moyenne aux autres machines du groupe (a) a celle du groupe voisin le plus proche (b) :
+ * (b - a) / max(a, b), proche de 1 pour une machine bien groupee, negative si elle est plus proche d'un autre groupe.
  */
-void sendResults(MyResult* r) {
-	MPI_Send(r, 1, ResultType, MASTER, 0, MPI_COMM_WORLD);
+void inferMisfits(Infer* in) {
+	int *count, *label = in->labels, h = in->nbHosts, nbGroups = 0, i, j, g;
+	float *sum, intra, inter;
+
+	count = (int*) malloc(sizeof(int) * (h + 1));
+	sum = (float*) malloc(sizeof(float) * (h + 1));
+	in->silhouette = (float*) malloc(sizeof(float) * (h + 1));
+	in->misfit = (int*) malloc(sizeof(int) * (h + 1));
+
+	if(count == NULL || sum == NULL || in->silhouette == NULL || in->misfit == NULL) {
+		fprintf(stderr, "ERROR: Can't allocate memory.");
+		exit(1);
+	}
+
+	for(i = 0; i < h; i++)
+		nbGroups += (label[i] == i);
+
+	for(i = 0; i < h; i++) {
+		in->silhouette[i] = 0;
+		in->misfit[i] = 0;
+
+		/* Un seul groupe : aucune machine ne peut etre mieux ailleurs */
+		if(nbGroups < 2)
+			continue;
+
+		for(g = 0; g < h; count[g] = 0, sum[g] = 0, g++);
+
+		for(j = 0; j < h; j++) {
+			if(j != i && in->d[i * h + j] >= 0) {
+				sum[label[j]] += in->d[i * h + j];
+				count[label[j]]++;
+			}
+		}
+
+		if(count[label[i]] == 0) {
+			in->misfit[i] = 1;
+			continue;
+		}
+
+		intra = sum[label[i]] / count[label[i]];
+		inter = FLT_MAX;
+
+		for(g = 0; g < h; g++) {
+			if(g != label[i] && count[g] > 0 && sum[g] / count[g] < inter)
+				inter = sum[g] / count[g];
+		}
+
+		if(inter < FLT_MAX) {
+			in->silhouette[i] = (inter - intra) / (inter > intra ? inter : intra);
+			in->misfit[i] = in->silhouette[i] < INFER_MISFIT;
+		}
+	}
+
+	free(count);
+	free(sum);
 }
 
 /*
- * Reception du resultat MyResult de l'envoyeur qui vient de realiser son test (pour le rank 0).
+ * Ecriture des nb machines members (indices dans in->hosts) regroupees selon leur groupe du niveau level, puis recursivement
+ * des niveaux inferieurs jusqu'aux machines. Un groupe est nomme par son niveau et une de ses machines (ex. L1-node12). En DOT,
+ * chaque groupe et chaque machine est relie a son parent ; en YAML, les groupes sont des cles imbriquees et les machines des
+ * listes.
  */
-void receiveResults(MyResult* r, int sender) {
-	MPI_Recv(r, 1, ResultType, sender, 0, MPI_COMM_WORLD, &status);
-}
+void inferEmit(FILE* f, int dot, char* parent, int level, int* members, int nb, Infer* in) {
+	char name[HOSTNAME_SIZE + 16];
+	int *sub, *used, nbSub, indent = 2 * (in->nbLevels - level), i, j, label;
+
+	if(level < 0) {
+		for(i = 0; i < nb; i++) {
+			if(dot)
+				fprintf(f, "  \"%s\" -> \"%s\";\n", parent, rankToHostname(in->hostnames, in->hosts[members[i]]));
+			else
+				fprintf(f, "%*s- %s\n", indent, "", rankToHostname(in->hostnames, in->hosts[members[i]]));
+		}
 
-/* Formatage du MyResult qui sera renvoye au MASTER */
-void formatTestsResult(MyResult* r, YourTest* t, int rank) {
-	int sizeHostname;
-	char* sep;
+		return;
+	}
 
-	/* Les deux joueurs sont renseignes, et la latence est mise a -1 : si le test n'est
-	jamais utilise, la latence restera ainsi, et pourra alors etre un indicateur de la non
-	pertinence du resultat. */
-	r->result.sender = rank;
-	r->result.recver = t->withRank;
-	r->result.latency = r->result.flow = -1;
+	sub = (int*) malloc(sizeof(int) * nb);
+	used = (int*) calloc(nb, sizeof(int));
 
-	/* Renseignement du nom du noeud courant */
-	MPI_Get_processor_name(r->myHostname, &sizeHostname);
+	if(sub == NULL || used == NULL) {
+		fprintf(stderr, "ERROR: Can't allocate memory.");
+		exit(1);
+	}
 
-	/* Reduction du nom du noeud a sa premiere partie (ex. on vire .site.grid5000.fr), si
-	celui-ci semble renvoyer un FQDN (presence d'au moins un point) en guise de hostname */
-	if((sep = strchr(r->myHostname, '.')) != NULL)
-		*sep = '\0';
+	for(i = 0; i < nb; i++) {
+		if(used[i])
+			continue;
+
+		label = in->labels[level * in->nbHosts + members[i]];
+
+		for(nbSub = 0, j = i; j < nb; j++) {
+			if(!used[j] && in->labels[level * in->nbHosts + members[j]] == label) {
+				sub[nbSub++] = members[j];
+				used[j] = 1;
+			}
+		}
+
+		sprintf(name, "L%d-%s", level, rankToHostname(in->hostnames, in->hosts[label]));
+
+		if(dot)
+			fprintf(f, "  \"%s\" -> \"%s\";\n", parent, name);
+		else
+			fprintf(f, "%*s%s :\n", indent, "", name);
+
+		inferEmit(f, dot, name, level - 1, sub, nbSub, in);
+	}
+
+	free(sub);
+	free(used);
 }
 
 /*
- * Tests de debit/latence de l'envoyeur vers le receveur.
+ * Resume de la topologie inferee : nombre de machines, seuils des niveaux et nombre de groupes de chacun, machines mal integrees.
  */
-void benchTests(YourTest* t, Bench* r, int pktSize) {
-	double start, stop;
+void displayInfer(Infer* in) {
+	int level, i, nbGroups;
 
-	/* Un mot vide (4 octets) est envoye au receveur, qui repondra immediatement un mot de la meme nature.
-	Le temps est compte, de l'envoi du mot au receveur jusqu'a la reception de sa reponse. */
-	start = MPI_Wtime();
-	MPI_Send(buffer, 0, MPI_BYTE, t->withRank, 1, MPI_COMM_WORLD);
-	MPI_Recv(buffer, 0, MPI_BYTE, t->withRank, 1, MPI_COMM_WORLD, &status);
-	stop = MPI_Wtime();
+	printf("\nInferred topology : %d hosts, %d levels\n", in->nbHosts, in->nbLevels);
 
-	/* La latence est calculee en fonction du temps mis par le mot pour arriver au destinataire (division par 2
-	pour eliminer le tps de reponse qui est cense etre identique.
-	Passage de seconde a microseconde en multiplisant par un million. */
-	r->latency = ((stop-start) / 2) * 1e6;
+	for(level = 0; level < in->nbLevels; level++) {
+		for(nbGroups = 0, i = 0; i < in->nbHosts; i++)
+			nbGroups += (in->labels[level * in->nbHosts + i] == i);
 
-	/* Un mot plus ou moins consequent (option -s) est envoye au receveur. Celui-ci renvoyant un mot vide.
-	Le temps est egalement compte, de l'envoi jusqu'a la reception. */
-	start = MPI_Wtime();
-	MPI_Send(buffer, pktSize, MPI_BYTE, t->withRank, 1, MPI_COMM_WORLD);
-	MPI_Recv(buffer, 0, MPI_BYTE, t->withRank, 1, MPI_COMM_WORLD, &status);
-	stop = MPI_Wtime();
+		printf("Level %d : %d groups (distance up to %.3f)\n", level, nbGroups, in->thresholds[level]);
+	}
 
-	/* La difference de temps est prise en compte. On lui soustraie deux fois la latence - en seconde grace a la
-	division - d'un mot vide (soit le tps que met le tuyau a faire transiter les donnees, quelque soit la taille des
-	donnees). Enfin, on divise le nombre d'octets qui ont transites avec ce resultat. On divise le tout par 1024 au
-	carre pour avoir des Mo/s au lieu de o/s. Cette facon de proceder releve de l'approche NWS : http://nws.cs.ucsb.ed */
-	r->flow = pktSize / ((stop-start) - (2*r->latency/1e6)) / pow(1024, 2);
+	for(i = 0; i < in->nbHosts; i++) {
+		if(in->misfit[i])
+			printf("Misfit : %s (silhouette %.3f)\n", rankToHostname(in->hostnames, in->hosts[i]), in->silhouette[i]);
+	}
 }
 
 /*
- * Reponses automatiques aux envoi du noeud qui joue le role d'envoyeur.
+ * Placement des ranks d'une application sur les machines testees (option -G). Chaque rank teste est un emplacement ; le schema
+ * de communication (anneau, stencil ou graphe pondere) relie les ranks de l'application, et le cout d'un placement est la somme
+ * sur ses liens du poids multiplie par le temps mesure d'un mot de la taille testee (latence + taille / debit) entre les deux
+ * emplacements. Un placement glouton est affine par echanges de paires, puis ecrit en rankfile Open MPI. Renvoie 0 si le
+ * placement est impossible ou le rankfile ne peut etre ecrit (message deja affiche).
  */
-void responsesToTests(YourTest* t, int pktSize) {
-	MPI_Recv(buffer, 0, MPI_BYTE, t->withRank, 1, MPI_COMM_WORLD, &status);
-	MPI_Send(buffer, 0, MPI_BYTE, t->withRank, 1, MPI_COMM_WORLD);
+int placeRanks(Results* r, Options* o, int display) {
+	PlaceGraph g;
+	FILE* f;
+	float *c, launchCost, cost;
+	int *slots, *map, *local, *count, nb = 0, nbSwaps, i, j;
+
+	slots = (int*) malloc(sizeof(int) * r->nbNodes);
+	local = (int*) malloc(sizeof(int) * r->nbNodes);
+	count = (int*) calloc(r->nbNodes, sizeof(int));
+
+	if(slots == NULL || local == NULL || count == NULL) {
+		fprintf(stderr, "ERROR: Can't allocate memory.");
+		exit(1);
+	}
+
+	/* Emplacements : les ranks avec au moins un lien teste, dans l'ordre de lancement */
+	for(i = 1; i < r->nbNodes; i++) {
+		for(j = 1; j < r->nbNodes && !resultTested(r, i, j) && !resultTested(r, j, i); j++);
+
+		if(j < r->nbNodes)
+			slots[nb++] = i;
+	}
+
+	if(nb < 2 || !placeGraph(&g, nb, o)) {
+		if(nb < 2)
+			fprintf(stderr, "ERROR: The placement needs at least two tested ranks.");
+
+		free(slots);
+		free(local);
+		free(count);
+		return 0;
+	}
+
+	c = (float*) malloc(sizeof(float) * nb * nb);
+	map = (int*) malloc(sizeof(int) * nb);
+
+	if(c == NULL || map == NULL) {
+		fprintf(stderr, "ERROR: Can't allocate memory.");
+		exit(1);
+	}
+
+	placeCosts(r, slots, nb, o, c);
+
+	/* Cout de reference : le rank u de l'application sur le u-ieme emplacement, comme au lancement */
+	for(i = 0; i < nb; map[i] = i, i++);
+
+	launchCost = placeCost(&g, c, map);
+
+	placeGreedy(&g, c, map);
+	nbSwaps = placeLocalSearch(&g, c, map);
+	cost = placeCost(&g, c, map);
+
+	/* Un placement qui ne fait pas mieux que l'ordre de lancement est abandonne */
+	if(cost > launchCost) {
+		for(i = 0; i < nb; map[i] = i, i++);
+
+		cost = launchCost;
+	}
+
+	/* Rankfile : un rank de l'application par ligne, sur la machine de son emplacement, slot = indice de l'emplacement dans
+	sa machine */
+	f = fopen(o->rankFile, "w");
+
+	if(f == NULL)
+		fprintf(stderr, "ERROR: Can't write the rankfile %s.", o->rankFile);
+	else {
+		fprintf(f, "# bwlat placement : %s, cost %.3f us (launch order %.3f us)\n", (o->place == PLACE_GRAPH) ? o->placeGraphFile :
+			(o->place == PLACE_RING) ? "ring" : (o->place == PLACE_STENCIL2D) ? "stencil2d" : "stencil3d", cost, launchCost);
+
+		for(i = 0; i < nb; i++)
+			local[i] = count[r->nodeOf[slots[i]]]++;
+
+		for(i = 0; i < nb; i++)
+			fprintf(f, "rank %d=%s slot=%d\n", i, rankToHostname(r->hostnames, slots[map[i]]), local[map[i]]);
 
-	MPI_Recv(buffer, pktSize, MPI_BYTE, t->withRank, 1, MPI_COMM_WORLD, &status);
-	MPI_Send(buffer, 0, MPI_BYTE, t->withRank, 1, MPI_COMM_WORLD);
+		fclose(f);
+	}
+
+	if(display && f != NULL) {
+		printf("\nPlacement : %d ranks, cost %.3f us in launch order, %.3f us placed (%.1f%%, %d swaps), rankfile %s\n", nb,
+			launchCost, cost, (launchCost > 0) ? 100 * (cost - launchCost) / launchCost : 0, nbSwaps, o->rankFile);
+	}
+
+	free(g.first);
+	free(g.adj);
+	free(g.weight);
+	free(slots);
+	free(local);
+	free(count);
+	free(c);
+	free(map);
+
+	return f != NULL;
 }
 
 /*
- * Creation de tous les tests qui seront repartis entre tous les noeuds, pour le mode bissection, sans les envoyer et en les
- * stockant dans un tableau.
+ * Graphe de communication des nb ranks de l'application. L'anneau relie u a u+1 ; les stencils relient chaque rank a ses
+ * voisins directs d'une grille 2D ou 3D sans bords periodiques, dimensionnee par MPI_Dims_create ; le graphe pondere est lu
+ * dans un fichier de lignes "u v [poids]" (poids 1 par defaut, # pour les commentaires). Renvoie 0 si le fichier est invalide
+ * (message deja affiche).
  */
-void bissPrepareAllTests(YourTest* bissTests, int nbNodes) {
-	int m, i;
-	YourTest t;
+int placeGraph(PlaceGraph* g, int nb, Options* o) {
+	FILE* f = NULL;
+	char line[256];
+	float *weight = NULL, w;
+	int *from = NULL, *to = NULL, dims[3] = {0, 0, 0}, nbDims, nbEdges = 0, size = 0, u, v, x, d, i;
+
+	if(o->place == PLACE_GRAPH) {
+		f = fopen(o->placeGraphFile, "r");
+
+		if(f == NULL) {
+			fprintf(stderr, "ERROR: Can't read the communication graph %s.", o->placeGraphFile);
+			return 0;
+		}
+	}
 
-	/* Le rank 0 ne participe pas */
-	nbNodes--;
+	/* Grille des stencils, dans l'ordre des rangs de MPI_Cart_create (la derniere dimension variant le plus vite) */
+	nbDims = (o->place == PLACE_STENCIL3D) ? 3 : 2;
 
-	/* Si il y a un nb impaire de noeud, on ignore le dernier, en le faisant quand meme participer
-	aux fonctions collectives*/
-	if(nbNodes % 2) {
-		bissTests[nbNodes].role = DEACTIVATED;
-		bissTests[nbNodes].withRank = -1;
-		nbNodes--;
+	if(o->place == PLACE_STENCIL2D || o->place == PLACE_STENCIL3D)
+		MPI_Dims_create(nb, nbDims, dims);
+
+	for(u = 0; ; u++) {
+
+		/* Liens suivants : une ligne du fichier, ou les voisins du rank u */
+		if(o->place == PLACE_GRAPH) {
+			if(fgets(line, sizeof(line), f) == NULL)
+				break;
+
+			w = 1;
+
+			if(line[strspn(line, " \t\r\n")] == '\0' || line[strspn(line, " \t")] == '#')
+				continue;
+
+			if(sscanf(line, "%d %d %f", &v, &x, &w) < 2 || v < 0 || v >= nb || x < 0 || x >= nb || v == x || w < 0) {
+				fprintf(stderr, "ERROR: Invalid line in the communication graph %s (ranks 0 to %d): %s", o->placeGraphFile, nb - 1, line);
+				fclose(f);
+				free(from);
+				free(to);
+				free(weight);
+				return 0;
+			}
+		} else if(u >= nb)
+			break;
+
+		if(size < nbEdges + 6) {
+			size = 2 * size + 64;
+			from = (int*) realloc(from, sizeof(int) * size);
+			to = (int*) realloc(to, sizeof(int) * size);
+			weight = (float*) realloc(weight, sizeof(float) * size);
+
+			if(from == NULL || to == NULL || weight == NULL) {
+				fprintf(stderr, "ERROR: Can't allocate memory.");
+				exit(1);
+			}
+		}
+
+		if(o->place == PLACE_GRAPH) {
+			from[nbEdges] = v;
+			to[nbEdges] = x;
+			weight[nbEdges++] = w;
+		} else if(o->place == PLACE_RING) {
+			from[nbEdges] = u;
+			to[nbEdges] = (u + 1) % nb;
+			weight[nbEdges++] = 1;
+
+			/* Deux ranks : un seul lien */
+			if(nb == 2 && u == 1)
+				nbEdges--;
+		} else {
+
+			/* Voisin suivant dans chaque dimension de la grille */
+			for(d = 1, i = nbDims - 1; i >= 0; d *= dims[i], i--) {
+				if((u / d) % dims[i] + 1 < dims[i]) {
+					from[nbEdges] = u;
+					to[nbEdges] = u + d;
+					weight[nbEdges++] = 1;
+				}
+			}
+		}
 	}
 
-	m = nbNodes / 2;
+	if(o->place == PLACE_GRAPH)
+		fclose(f);
 
-	/* Pour chaque paire */
-	for(i = 1; i <= m; i++) {
+	/* Listes d'adjacence, chaque lien dans les deux sens */
+	g->nb = nb;
+	g->first = (int*) calloc(nb + 1, sizeof(int));
+	g->adj = (int*) malloc(sizeof(int) * (2 * nbEdges + 1));
+	g->weight = (float*) malloc(sizeof(float) * (2 * nbEdges + 1));
+
+	if(g->first == NULL || g->adj == NULL || g->weight == NULL) {
+		fprintf(stderr, "ERROR: Can't allocate memory.");
+		exit(1);
+	}
+
+	for(i = 0; i < nbEdges; i++) {
+		g->first[from[i] + 1]++;
+		g->first[to[i] + 1]++;
+	}
+
+	for(u = 0; u < nb; u++)
+		g->first[u + 1] += g->first[u];
+
+	for(i = 0; i < nbEdges; i++) {
+		g->adj[g->first[from[i]]] = to[i];
+		g->weight[g->first[from[i]]++] = weight[i];
+		g->adj[g->first[to[i]]] = from[i];
+		g->weight[g->first[to[i]]++] = weight[i];
+	}
+
+	/* Les remplissages ont decale first d'une liste : retour au debut de chaque liste */
+	for(u = nb; u > 0; u--)
+		g->first[u] = g->first[u - 1];
+
+	g->first[0] = 0;
+
+	free(from);
+	free(to);
+	free(weight);
+
+	return 1;
+}
+
+/*
+ * Couts des liens entre les nb emplacements (matrice symetrique, en microsecondes) : temps d'un mot de la taille testee, latence
+ * plus taille sur debit, moyen sur les sens testes. Un lien non teste prend le cout du pire lien teste.
+ */
+void placeCosts(Results* r, int* slots, int nb, Options* o, float* c) {
+	float worst = 0, cost;
+	int a, b, i, j, k, n;
+
+	for(a = 0; a < nb; a++) {
+		c[a * nb + a] = 0;
+
+		for(b = a + 1; b < nb; b++) {
+			for(cost = 0, n = 0, k = 0; k < 2; k++) {
+				i = k ? slots[b] : slots[a];
+				j = k ? slots[a] : slots[b];
+
+				if(resultTested(r, i, j) && RESULT(r, offsetof(Bench, flow), i, j) > 0) {
+					cost += RESULT(r, offsetof(Bench, latency), i, j) + o->pktSize / (RESULT(r, offsetof(Bench, flow), i, j) * pow(1024, 2)) * 1e6;
+					n++;
+				}
+			}
 
-		/* Le receveur de la paire est le n ieme de la seconde moitie */
-		bissTests[m+i].role = RECVER;
-		bissTests[m+i].withRank = i;
+			c[a * nb + b] = c[b * nb + a] = n ? cost / n : -1;
 
-		/* L'envoyeur est le n ieme de la premiere moitie */
-		bissTests[i].role = SENDER;
-		bissTests[i].withRank = m+i;
+			if(c[a * nb + b] > worst)
+				worst = c[a * nb + b];
+		}
+	}
+
+	for(a = 0; a < nb * nb; a++) {
+		if(c[a] < 0)
+			c[a] = worst;
 	}
 }
 
 /*
- * Creations des tests pour la bissection, en creant les paires de noeuds de facon aleatoire (sans envoyer les tests,
- * et en les stockant dans un tableau.
+ * Cout du placement map (rank de l'application => emplacement) : chaque lien compte une fois.
  */
-void bissPrepareAllRandTests(YourTest* bissTests, int nbNodes) {
-	int i, r, randRank, ranks[2], iLeft, *ranksLeft, nbLeft;
-	YourTest t;
+float placeCost(PlaceGraph* g, float* c, int* map) {
+	float cost = 0;
+	int u, e;
+
+	for(u = 0; u < g->nb; u++) {
+		for(e = g->first[u]; e < g->first[u + 1]; e++) {
+			if(g->adj[e] > u)
+				cost += g->weight[e] * c[map[u] * g->nb + map[g->adj[e]]];
+		}
+	}
 
-	/* Le rank 0 ne participe pas */
-	nbNodes--;
+	return cost;
+}
 
-	/* Si il y a un nb impaire de noeud, on ignore le dernier, en le faisant quand meme participer
-	aux fonctions collectives*/
-	if(nbNodes % 2) {
-		bissTests[nbNodes].role = DEACTIVATED;
-		bissTests[nbNodes].withRank = -1;
-		nbNodes--;
-	}
+/*
+ * Placement glouton : le rank le plus lie aux ranks deja poses (a poids egal, celui qui communique le plus) va sur l'emplacement
+ * libre qui lui coute le moins vers eux ; le premier rank de chaque composante va sur l'emplacement libre le plus central.
+ * O(nb^2) hors liens.
+ */
+void placeGreedy(PlaceGraph* g, float* c, int* map) {
+	float *link, *total, *central, cost, best;
+	int *freeSlot, nb = g->nb, u, next, s, e, i;
 
-	/* Nombre et liste des noeuds qui n'ont pas encore de test attribue */
-	nbLeft = nbNodes;
-	ranksLeft = (int*) malloc(sizeof(int) * nbLeft);
+	link = (float*) calloc(nb, sizeof(float));
+	total = (float*) calloc(nb, sizeof(float));
+	central = (float*) calloc(nb, sizeof(float));
+	freeSlot = (int*) malloc(sizeof(int) * nb);
 
-	if(ranksLeft == NULL) {
+	if(link == NULL || total == NULL || central == NULL || freeSlot == NULL) {
 		fprintf(stderr, "ERROR: Can't allocate memory.");
 		exit(1);
 	}
 
-	/* Initialisation des noeuds : avec la valeur 1, chacun est encore vaquant */
-	for(i = 0; i < nbLeft; ranksLeft[i++] = 1);
-
-	/* Pour tous les noeuds vaquants restants */
-	while(nbLeft != 0) {
+	for(s = 0; s < nb; s++) {
+		freeSlot[s] = 1;
+		map[s] = -1;
 
-		/* Extraction de deux noeuds choisis aleatoirement parmis les noeuds encore disponibles
-		Premier tour pour l'envoyeur, second tour pour le receveur */
-		for(i = 0; i < 2; i++) {
-			srand(time(NULL));
+		for(i = 0; i < nb; i++)
+			central[s] += c[s * nb + i];
 
-			/* Tirage d'un nombre aleatoire qui definira le rank du noeud choisi, parmis les ranks restants.
-			Ex: si 3 est tire, le rank selectionne sera le 3ieme qui n'a pas encore ete utilise */
-			randRank = rand() % (nbLeft-1);
+		for(e = g->first[s]; e < g->first[s + 1]; e++)
+			total[s] += g->weight[e];
+	}
 
-			r = -1;
-			iLeft = 0;
-			ranks[i] = -1;
+	for(i = 0; i < nb; i++) {
+		for(next = -1, u = 0; u < nb; u++) {
+			if(map[u] < 0 && (next < 0 || link[u] > link[next] || (link[u] == link[next] && total[u] > total[next])))
+				next = u;
+		}
 
-			/* Pour tous les ranks jusqu'a ce que le n ieme rank encore vaquant soit atteint */
-			while(ranks[i] == -1) {
+		for(best = FLT_MAX, s = 0; s < nb; s++) {
+			if(!freeSlot[s])
+				continue;
 
-				/* Si le rank en cours est encore vaquant */
-				if(ranksLeft[++r] != -1) {
+			for(cost = 0, e = g->first[next]; e < g->first[next + 1]; e++) {
+				if(map[g->adj[e]] >= 0)
+					cost += g->weight[e] * c[s * nb + map[g->adj[e]]];
+			}
 
-					/* Si le rank en cours correspond au rank du tirage aleatoire, selection de ce rank (+1, puisque le rank 0 a ete supprime) */
-					if(iLeft == randRank)
-						ranks[i] = r + 1;
+			if(link[next] == 0)
+				cost = central[s];
 
-					/*  Sinon incrementation du nb des ranks encore vaquants deja rencontres */
-					iLeft++;
-				}
+			if(cost < best) {
+				best = cost;
+				map[next] = s;
 			}
-
-			/* Ce rank ne pourra plus etre selectionne */
-			ranksLeft[r] = -1;
 		}
 
-		/* Deux ranks en moins a attribuer */
-		nbLeft -= 2;
-
-		/* Creation du test du receveur, qui attendra alors un message de son camarade de jeu */
-		bissTests[ranks[1]].role = RECVER;
-		bissTests[ranks[1]].withRank = ranks[0];
+		freeSlot[map[next]] = 0;
 
-		/* Creation du test de l'envoyeur */
-		bissTests[ranks[0]].role = SENDER;
-		bissTests[ranks[0]].withRank = ranks[1];
+		for(e = g->first[next]; e < g->first[next + 1]; e++)
+			link[g->adj[e]] += g->weight[e];
 	}
-}
 
-/*
- * Fonction collective d'envoi du test associe a chaque rank, depuis le MASTER.
- */
-void bissTransmitAllTests(YourTest* bissTests, YourTest* t) {
-	MPI_Scatter(bissTests, 1, TestType, t, 1, TestType, MASTER, MPI_COMM_WORLD);
+	free(link);
+	free(total);
+	free(central);
+	free(freeSlot);
 }
 
 /*
- * Fonction collective d'envoi d'un broadcast vide, permettant de lancer un depart synchro des tests de bissections.
+ * Recherche locale : tout echange des emplacements de deux ranks qui baisse le cout est fait, par passes sur toutes les paires
+ * jusqu'a ce qu'aucun echange ne gagne (ou PLACE_PASSES passes). Renvoie le nombre d'echanges.
  */
-void bissLaunchAllTests() {
-	MPI_Bcast(buffer, 0, MPI_BYTE, MASTER, MPI_COMM_WORLD);
+int placeLocalSearch(PlaceGraph* g, float* c, int* map) {
+	int nbSwaps = 0, improved = 1, pass, u, v, s;
+	float best = placeCost(g, c, map), delta;
+
+	for(pass = 0; improved && pass < PLACE_PASSES; pass++) {
+		for(improved = 0, u = 0; u < g->nb; u++) {
+			for(v = u + 1; v < g->nb; v++) {
+
+				/* Marge relative contre les echanges sans gain reel (arrondis des flottants) */
+				delta = placeSwapDelta(g, c, map, u, v);
+
+				if(delta < -1e-6 * best) {
+					s = map[u];
+					map[u] = map[v];
+					map[v] = s;
+					best += delta;
+					improved = 1;
+					nbSwaps++;
+				}
+			}
+		}
+	}
+
+	return nbSwaps;
 }
 
 /*
- * Fonction collectice d'envoi des resultats de la part de chaque rank vers le MASTER.
+ * Variation du cout si les ranks u et v echangent leurs emplacements : seuls leurs liens changent (le lien u-v garde son cout,
+ * la matrice etant symetrique).
  */
-void bissTransmitAllResults(MyResult* bissResults, MyResult* r) {
-	MPI_Gather(r, 1, ResultType, bissResults, 1, ResultType, MASTER, MPI_COMM_WORLD);
-}
+float placeSwapDelta(PlaceGraph* g, float* c, int* map, int u, int v) {
+	float delta = 0;
+	int e, k, x, y, n;
 
-/* Fonction permettant la conversion numero de rank vers Hostname. */
-char* rankToHostname(MyResult** r, MyResult* rBiss, int rank, int bissection) {
-	if(bissection)
-		return rBiss[rank].myHostname;
-	else
-		return r[rank][rank == 1 ? 2 : 1].myHostname;
+	for(k = 0; k < 2; k++) {
+		x = k ? v : u;
+		y = k ? u : v;
+
+		for(e = g->first[x]; e < g->first[x + 1]; e++) {
+			n = g->adj[e];
+
+			if(n != y)
+				delta += g->weight[e] * (c[map[y] * g->nb + map[n]] - c[map[x] * g->nb + map[n]]);
+		}
+	}
+
+	return delta;
 }
 
 /*
- * Affichage des resultats sous forme de tableau texte non-parsable.
+ * Resultat d'un test a partir de ses nb repetitions : moyennes de tous les champs, puis chaque repetition est conservee dans les
+ * histogrammes de latence et de debit. La latence et le debit retenus pour la paire sont leurs medianes exactes, qu'une
+ * repetition lente ne peut pas fausser comme une moyenne (les memes que celles du mode adaptatif, voir benchsConverged) ; les
+ * histogrammes, arrondis a leurs intervalles, ne servent qu'aux centiles. Seul un resume de chaque distribution est renvoye au
+ * MASTER.
  */
-void displayTab(MyResult** r, MyResult* rBiss, int bissection, int nbNodes) {
-	int x, y, i;
+void benchsSummary(Bench* sameBenchs, int nb, Bench* r, Histo* latencyHisto, Histo* flowHisto) {
+	int i;
 
-	/* Affichage des resultats de la bissections sous forme d'un tableau simple dont la premier colonne indique
-	l'envoyeur et la seconde le receveur avec la latence et le debit calculees */
-	if(bissection) {
+	averageBenchs(sameBenchs, nb, r);
 
-		/* Pour chaque envoyeur */
-		for(i = 1; i < nbNodes; i++) {
+	histoInit(latencyHisto);
+	histoInit(flowHisto);
 
-			/* La latence differente de -1 signifie que le MyResult a ete exploite et n'est pas le retour d'un
-			RECVER ou d'un DEACTIVATED */
-			if(rBiss[i].result.latency != -1) {
-				puts("+---------------------+----------------------+");
-				printf("| From %-15s", rankToHostname(r, rBiss, i, bissection));
-				printf("| To %-17s |\n", rankToHostname(r, rBiss, rBiss[i].result.recver, bissection));
-				printf("|                     ");
-				printf("| %17.3f us |\n", rBiss[i].result.latency);
-				printf("|                     ");
-				printf("| %15.3f Mo/s |\n", rBiss[i].result.flow);
-			}
-		}
+	for(i = 0; i < nb; i++) {
+		histoAdd(latencyHisto, sameBenchs[i].latency);
+		histoAdd(flowHisto, sameBenchs[i].flow);
+	}
 
-		puts("+---------------------+----------------------+");
+	r->latency = benchsMedian(sameBenchs, nb, offsetof(Bench, latency));
+	r->flow = benchsMedian(sameBenchs, nb, offsetof(Bench, flow));
+	r->samples = nb;
 
-	/* Affichage des resultats sous forme d'une matrice equilibree de tous les noeuds, avec la debit et la latence pour chaque
-	paire de noeud possible, dans les deux sens */
-	} else {
+	/* Nombre de mots corrompus, et non proportion */
+	if(r->corrupted > 0)
+		r->corrupted = floor(r->corrupted * nb + 0.5);
 
-		/* Premiere ligne de tirets */
-		printf("                       ");
-		for(x = 1; x < nbNodes; printf("+----------------------"), x++);
-		printf("+\n                       ");
+	histoSummary(latencyHisto, r, offsetof(Bench, latencyMin));
+	histoSummary(flowHisto, r, offsetof(Bench, flowMin));
+}
 
-		/* Lignes des entetes de colonnes (receveurs) */
-		for(x = 1; x < nbNodes; printf("| To %-17s ", rankToHostname(r, rBiss, x++, bissection)));
-		printf("|\n");
+/*
+ * Moyenne, champ par champ, des resultats des nb repetitions d'un meme test. Les champs desactives (-1) le restent.
+ */
+void averageBenchs(Bench* sameBenchs, int nb, Bench* r) {
+	size_t field;
+	int i;
 
-		/* Ligne de tirets de separation */
-		for(x = 0; x < nbNodes; printf("+----------------------"), x++);
-		puts("+");
+	for(field = offsetof(Bench, latency); field < sizeof(Bench); field += sizeof(float)) {
+		BENCH_FIELD(r, field) = 0;
 
-		/* Pour chaque ligne/envoyeur */
-		for(y = 1; y < nbNodes; y++) {
+		for(i = 0; i < nb; i++)
+			BENCH_FIELD(r, field) += BENCH_FIELD(&sameBenchs[i], field);
 
-			/* Entete */
-			printf("| From %-15s ", r[y][y == 1 ? 2 : 1].myHostname);
+		BENCH_FIELD(r, field) /= nb;
+	}
+}
 
-			/* Latence, ou suite de tirets si on est l'envoyeur correspond au receveur */
-			for(x = 1; x < nbNodes; x++) {
-				(x == y) ?
-					printf("|----------------------") :
-					printf("| %17.3f us ", r[y][x].result.latency);
-			}
+/*
+ * Statistiques (min, max, somme et moyenne) d'un champ quelconque des Bench de toutes les paires testees (toute la matrice, ou
+ * les paires de la bissection), designe par son decalage dans la structure (ex. offsetof(Bench, streamFlow)). Seuls les liens
+ * de la classe linkClass sont pris en compte (TOPO_ALL, TOPO_INTRA ou TOPO_INTER).
+ */
+void fieldStats(Results* r, StatsResult* s, size_t field, int linkClass) {
+	int i, j, k;
+	float value;
 
-			printf("|\n|                      ");
+	s->sum = s->avg = 0;
+	s->nb = 0;
 
-			/* Debit, ou suite de tirets si on est l'envoyeur correspond au receveur */
-			for(x = 1; x < nbNodes; x++) {
-				(x == y) ?
-					printf("|----------------------") :
-					printf("| %15.3f Mo/s ", r[y][x].result.flow);
-			}
+	for(i = 1; i < r->nbNodes; i++) {
+		for(k = 0; k < resultNbRecvers(r); k++) {
+			j = resultRecver(r, i, k);
 
-			/* Fermeture de ligne */
-			puts("|");
-			for(x = 1; x < nbNodes+1; printf("+----------------------"), x++);
-			puts("+");
+			if(!resultTested(r, i, j) || !linkInClass(r->nodeOf, i, j, linkClass))
+				continue;
+
+			value = RESULT(r, field, i, j);
+
+			if(s->nb == 0 || value < BENCH_FIELD(&s->min, field))
+				loadResult(r, i, j, &s->min);
+
+			if(s->nb == 0 || value > BENCH_FIELD(&s->max, field))
+				loadResult(r, i, j, &s->max);
+
+			s->sum += value;
+			s->nb++;
 		}
 	}
+
+	if(s->nb > 0)
+		s->avg = s->sum / s->nb;
 }
-/* 
- * Affichage des statistiques en relation avec la matrice ou la bissection sous forme de texte non-parsable.
- * Latence min et max ainsi que debit min et max.
- * Ainsi que les sommes et les moyennes.
+
+/*
+ * Affichage des statistiques d'un champ des Bench calculees par fieldStats.
  */
-void displayStats(MyResult** r, MyResult* rBiss, StatsResult* latencyStats, StatsResult* flowStats, int nbNodes, int bissection) {
+void displayFieldStats(Results* r, StatsResult* s, size_t field, char* title, char* unit) {
+	if(s->nb == 0)
+		return;
 
-	puts("\nLatency :");
+	printf("\n%s :\n", title);
 
-	/* Latence Maximum et affichage de la paire de noeuds correspondante, en hostname */
+	/* Maximum et affichage de la paire de noeuds correspondante, en hostname */
 	printf(
-		"Max : %.3f us \tFrom %s to %s\n", 
-		latencyStats->max->latency, 
-		rankToHostname(r, rBiss, latencyStats->max->sender, bissection), 
-		rankToHostname(r, rBiss, latencyStats->max->recver, bissection)
-	);
-	
-	/* Latence Minimum et affichage de la paire de noeuds correspondante, en hostname */
-        printf(
-		"Min : %.3f us \tFrom %s to %s\n",
-		latencyStats->min->latency, 
-		rankToHostname(r, rBiss, latencyStats->min->sender, bissection), 
-		rankToHostname(r, rBiss, latencyStats->min->recver, bissection)
+		"Max : %.3f %s \tFrom %s to %s\n",
+		BENCH_FIELD(&s->max, field), unit,
+		rankToHostname(r->hostnames, s->max.sender),
+		rankToHostname(r->hostnames, s->max.recver)
 	);
 
-	/* Somme des latences et moyenne */
-	printf("Sum : %.3f us\n", latencyStats->sum);
-	printf("Avg : %.3f us\n", latencyStats->avg);
-
-        puts("\nFlow :");
-
-	/* Debit Maximum et affichage de la paire de noeuds correspondante, en hostname */
-        printf(
-		"Max : %.3f Mo/s \tFrom %s to %s\n", 
-		flowStats->max->flow, 
-		rankToHostname(r, rBiss, flowStats->max->sender, bissection), 
-		rankToHostname(r, rBiss, flowStats->max->recver, bissection)
+	/* Minimum et affichage de la paire de noeuds correspondante, en hostname */
+	printf(
+		"Min : %.3f %s \tFrom %s to %s\n",
+		BENCH_FIELD(&s->min, field), unit,
+		rankToHostname(r->hostnames, s->min.sender),
+		rankToHostname(r->hostnames, s->min.recver)
 	);
 
-	/* Debit Minimum et affichage de la paire de noeuds correspondante, en hostname */
-        printf(
-		"Min : %.3f Mo/s \tFrom %s to %s\n", 
-		flowStats->min->flow, 
-		rankToHostname(r, rBiss, flowStats->min->sender, bissection), 
-		rankToHostname(r, rBiss, flowStats->min->recver, bissection)
-	);
-	
-	/* Somme des debits et moyenne */
-	printf("Sum : %.3f Mo/s\n", flowStats->sum);
-        printf("Avg : %.3f Mo/s\n", flowStats->avg);
+	/* Somme et moyenne */
+	printf("Sum : %.3f %s\n", s->sum, unit);
+	printf("Avg : %.3f %s\n", s->avg, unit);
 }
 
 /*
- * Ecriture en YAML dans un fichier des resultats.
+ * Statistiques du balayage des tailles : pour chaque taille, latences et debits min, max et moyens de toutes les paires
+ * testees (les courbes restees a -1 sont ignorees), ainsi que les n1/2 min, max et moyen.
  */
-void toYAML(MyResult** r, MyResult* rBiss, char* yamlFile, int nbNodes, int bissection) {
-	FILE* yaml;
-	int x, y, i;
+void sweepStatsOf(float* sweep, SweepStats* s, int nbNodes, Options* o) {
+	int x, y, k;
+	float *series, nHalf;
+	SweepPoint* p;
 
-	yaml = fopen(yamlFile, "w");
+	s->points = (SweepPoint*) malloc(sizeof(SweepPoint) * o->nbSizes);
 
-	if(yaml == NULL) {
-		fprintf(stderr, "ERROR: Can't write the yaml file.");
-		return;
+	if(s->points == NULL) {
+		fprintf(stderr, "ERROR: Can't allocate memory.");
+		exit(1);
 	}
 
-	/* Export du tableau des resultats (meme structure que pour la matrice) */
-	if(bissection) {
+	for(k = 0; k < o->nbSizes; k++) {
+		s->points[k].latencyMin = s->points[k].flowMin = 99999999.99;
+		s->points[k].latencyMax = s->points[k].flowMax = -1;
+		s->points[k].latencyAvg = s->points[k].flowAvg = 0;
+	}
 
-		/* Pour chaque envoyeur */
-		for(y = 1; y < nbNodes; y++) {
+	s->nHalfMin = 99999999.99;
+	s->nHalfMax = -1;
+	s->nHalfAvg = 0;
+	s->nbLinks = 0;
 
-			/* Resultat d'un envoyeur */
-			if(rBiss[y].result.latency != -1) {
-				fprintf(yaml, "%s\n", rankToHostname(r, rBiss, y, bissection));
-				fprintf(yaml, "  %s\n", rankToHostname(r, rBiss, rBiss[y].result.recver, bissection));
-				fprintf(yaml, "    latency ; %.3f\n", rBiss[y].result.latency);
-				fprintf(yaml, "    flow : %.3f\n", rBiss[y].result.flow);
-			}
-		}
+	for(y = 1; y < nbNodes; y++) {
+		for(x = 1; x < nbNodes; x++) {
+			series = sweepOf(sweep, y, x, nbNodes, o);
 
-	/* Export de la matrice des resultats (3 niveaux : envoyeur => receveur => debit/latence) */
-	} else {
+			/* Paire non testee (diagonale, receveur d'une bissection...) */
+			if(y == x || series[0] == -1)
+				continue;
 
-		/* Pour chaque envoyeur */
-		for(y = 1; y < nbNodes; y++) {
-			fprintf(yaml, "%s :\n", rankToHostname(r, rBiss, y, bissection));
+			for(k = 0; k < o->nbSizes; k++) {
+				p = &s->points[k];
 
-			/* Pour chaque receveur */
-			for(x = 1; x < nbNodes; x++) {
-				if(y != x) {
-					fprintf(yaml, "  %s :\n", rankToHostname(r, rBiss, x, bissection));
-					fprintf(yaml, "    latency : %.3f\n", r[y][x].result.latency);
-					fprintf(yaml, "    flow : %.3f\n", r[y][x].result.flow);
-				}
+				p->latencyMin = fmin(p->latencyMin, series[k]);
+				p->latencyMax = fmax(p->latencyMax, series[k]);
+				p->latencyAvg += series[k];
+
+				p->flowMin = fmin(p->flowMin, series[o->nbSizes + k]);
+				p->flowMax = fmax(p->flowMax, series[o->nbSizes + k]);
+				p->flowAvg += series[o->nbSizes + k];
 			}
+
+			nHalf = sweepNHalf(series, o);
+			s->nHalfMin = fmin(s->nHalfMin, nHalf);
+			s->nHalfMax = fmax(s->nHalfMax, nHalf);
+			s->nHalfAvg += nHalf;
+
+			s->nbLinks++;
 		}
 	}
 
-	fclose(yaml);
+	/* Calcul des moyennes */
+	if(s->nbLinks > 0) {
+		for(k = 0; k < o->nbSizes; k++) {
+			s->points[k].latencyAvg /= s->nbLinks;
+			s->points[k].flowAvg /= s->nbLinks;
+		}
+
+		s->nHalfAvg /= s->nbLinks;
+	}
 }
 
 /*
- * Exporte la somme des debits constates sous forme de coordonnees (x: nb noeuds, y: somme).
- * Sert pour la construction d'un graphique gnuplot du total des debits de bissections testees avec des nombres de noeuds
- * variables, et dans le cadre d'un script plus global.
+ * Initialisation d'un histogramme vide.
  */
-void toGnuplot(StatsResult* flowStats, int nbNodes) {
-	printf("%d\t%.3f\n", nbNodes, flowStats->sum);
+void histoInit(Histo* h) {
+	memset(h, 0, sizeof(Histo));
 }
 
 /*
- * Fonction de calcul des statistiques. 
+ * Indice de l'intervalle d'un histogramme correspondant a une valeur. Les intervalles sont logarithmiques, a la maniere des
+ * histogrammes HDR : chaque octave [2^e, 2^(e+1)[ est decoupee en HISTO_SUB intervalles de meme largeur, soit une precision
+ * relative constante de 1/HISTO_SUB quelle que soit l'echelle. Les valeurs hors bornes tombent dans le premier ou le dernier.
  */
-void stats(MyResult** r, MyResult* rBiss, StatsResult* latencyStats, StatsResult* flowStats, int nbNodes, int bissection) {
-	int i, j;
-	Bench initLatencyMin, initLatencyMax, initFlowMin, initFlowMax;
-	
-	/* Initialisation de la structure benchsStatsBounds */
-	latencyStats->min = &initLatencyMin;
-	latencyStats->min->latency = 99999999.99;
+int histoBucket(float value) {
+	int e, i;
+	double m;
 
-	latencyStats->max = &initLatencyMax;
-	latencyStats->max->latency = -1;
-	
-	flowStats->min = &initFlowMin;
-	flowStats->min->flow = 99999999.99;
+	if(value <= ldexp(1, HISTO_MIN_EXP))
+		return 0;
 
-	flowStats->max = &initFlowMax;
-	flowStats->max->flow = -1;
-	
-	/* Initialisation des sommes */
-	latencyStats->sum = flowStats->sum = 0;
+	/* value = m * 2^e, avec m dans [0.5, 1[ */
+	m = frexp(value, &e);
+	i = (e - 1 - HISTO_MIN_EXP) * HISTO_SUB + (int) ((2*m - 1) * HISTO_SUB);
 
-	if(bissection) {
-		for (i = 1; i < nbNodes; i++) {
+	return i >= HISTO_BUCKETS ? HISTO_BUCKETS - 1 : i;
+}
 
-			/* Si la latence est encore en etat d'initialisation on arrete */
-			if(rBiss[i].result.latency != -1) {
+/*
+ * Ajout d'un echantillon a un histogramme. Le min, le max et les moments (pour l'ecart type) restent exacts.
+ */
+void histoAdd(Histo* h, float value) {
+	if(h->count == 0 || value < h->min)
+		h->min = value;
 
-				/* Calcul de la Latence Minimum et attribution de l'adresse correspondante */
-				if (rBiss[i].result.latency < (latencyStats->min->latency)) {
-					latencyStats->min = &(rBiss[i].result);
-				}
+	if(h->count == 0 || value > h->max)
+		h->max = value;
 
-				/* Calcul de la Latence Maximum et attribution de l'adresse correspondante */
-				if (rBiss[i].result.latency > (latencyStats->max->latency)) {
-					latencyStats->max = &(rBiss[i].result);
-				}
+	h->sum += value;
+	h->sumSq += (double) value * value;
+	h->count++;
+	h->buckets[histoBucket(value)]++;
+}
 
-				/* Calcul du debit Minimum et attribution de l'adresse correspondante */
-				if (rBiss[i].result.flow < (flowStats->min->flow)) {
-					flowStats->min = &(rBiss[i].result);
-				}
+/*
+ * Ajout de tous les echantillons d'un histogramme a un autre.
+ */
+void histoMerge(Histo* h, Histo* from) {
+	int i;
 
-				/* Calcul du debit Maximum et attribution de l'adresse correspondante */
-				if (rBiss[i].result.flow > (flowStats->max->flow)) {
-					flowStats->max = &(rBiss[i].result);
-				} 
+	if(from->count == 0)
+		return;
 
-				/* Calcul de la somme des debits */
-				flowStats->sum += rBiss[i].result.flow;
-				
-				/* Calcul de la somme des latence */
-				latencyStats->sum += rBiss[i].result.latency;
-			}
-		}
-		
-		/* Calculs des Moyennes */
+	if(h->count == 0 || from->min < h->min)
+		h->min = from->min;
 
-		/* Debit */
-		flowStats->avg = flowStats->sum / ((nbNodes-1)/2);
+	if(h->count == 0 || from->max > h->max)
+		h->max = from->max;
 
-		/* Latence */
-		latencyStats->avg = latencyStats->sum / ((nbNodes-1)/2);
+	h->sum += from->sum;
+	h->sumSq += from->sumSq;
+	h->count += from->count;
 
-	} else {
+	for(i = 0; i < HISTO_BUCKETS; i++)
+		h->buckets[i] += from->buckets[i];
+}
 
-		/* Double boucle afin de parcourir l'ensemble de la matrice */
-		for (i = 1; i < nbNodes; i++) {
-			for (j = 1; j < nbNodes; ++j) {
+/*
+ * Percentile p (entre 0 et 1) d'un histogramme : milieu de l'intervalle qui contient l'echantillon de ce rang, borne par
+ * le min et le max exacts. Renvoie -1 pour un histogramme vide.
+ */
+float histoPercentile(Histo* h, double p) {
+	unsigned int rank, seen;
+	int i;
+	double value;
 
-				/* On evite le cas particulier ou le rank est egal (case vide) */
-				if(i != j) {
+	if(h->count == 0)
+		return -1;
 
-					/* Calcul de la Latence Minimum et attribution de l'adresse correspondante */
-					if (r[i][j].result.latency < (latencyStats->min->latency)) {
-						latencyStats->min = &(r[i][j].result);
-					}
+	/* Rang (a partir de 1) de l'echantillon cherche */
+	rank = (unsigned int) ceil(p * h->count);
 
-					/* Calcul de la Latence Maximum et attribution de l'adresse correspondante */
-					if (r[i][j].result.latency > (latencyStats->max->latency)) {
-						latencyStats->max = &(r[i][j].result);
-					}
-					
-					/* Calcul du debit Minimum et attribution de l'adresse correspondante */
-					if (r[i][j].result.flow < (flowStats->min->flow)) {
-						flowStats->min = &(r[i][j].result);
-					}
-		
-					/* Calcul du debit Maximum et attribution de l'adresse correspondante */
-					if (r[i][j].result.flow > (flowStats->max->flow)) {
-						flowStats->max = &(r[i][j].result);
-					} 
-
-					/* Calcul de la somme des debits */
-					flowStats->sum += r[i][j].result.flow;
-				
-					/* Calcul de la somme des latence */
-					latencyStats->sum += r[i][j].result.latency;
-				}
-			}
-		}
+	if(rank < 1)
+		return h->min;
 
-		/* Calcul des Moyennes et enregistrement */
+	if(rank >= h->count)
+		return h->max;
 
-		/* Debit */
-		flowStats->avg = flowStats->sum / (pow((nbNodes-1),2)-(nbNodes-1));
+	for(seen = 0, i = 0; i < HISTO_BUCKETS; i++) {
+		seen += h->buckets[i];
 
-		/* Latence */
-		latencyStats->avg = latencyStats->sum / (pow((nbNodes-1),2)-(nbNodes-1));
+		if(seen >= rank)
+			break;
 	}
+
+	/* Milieu de l'intervalle i */
+	value = ldexp(1 + (i % HISTO_SUB + 0.5) / HISTO_SUB, i / HISTO_SUB + HISTO_MIN_EXP);
+
+	if(value < h->min)
+		return h->min;
+
+	if(value > h->max)
+		return h->max;
+
+	return value;
+}
+
+/*
+ * Ecart type des echantillons d'un histogramme.
+ */
+float histoStddev(Histo* h) {
+	double avg;
+
+	if(h->count < 2)
+		return 0;
+
+	avg = h->sum / h->count;
+
+	return sqrt(fmax(0, h->sumSq / h->count - avg*avg));
+}
+
+/*
+ * Affichage sur une ligne de la distribution d'un histogramme (sous le format de displayStats).
+ */
+void displayHisto(Histo* h, char* unit) {
+	printf(
+		"Dist : Min %.3f \tP50 %.3f \tP90 %.3f \tP99 %.3f \tP99.9 %.3f \tMax %.3f \tStddev %.3f %s \t(%u samples)\n",
+		h->min,
+		histoPercentile(h, 0.5),
+		histoPercentile(h, 0.9),
+		histoPercentile(h, 0.99),
+		histoPercentile(h, 0.999),
+		h->max,
+		histoStddev(h),
+		unit,
+		h->count
+	);
+}
+
+/*
+ * Resume d'un histogramme dans les champs d'un Bench qui se suivent a partir de minField : min, P90, P99, P99.9, max et ecart
+ * type. La mediane a sa propre place (latence ou debit).
+ */
+void histoSummary(Histo* h, Bench* b, size_t minField) {
+	float values[6];
+	int k;
+
+	values[0] = h->min;
+	values[1] = histoPercentile(h, 0.9);
+	values[2] = histoPercentile(h, 0.99);
+	values[3] = histoPercentile(h, 0.999);
+	values[4] = h->max;
+	values[5] = histoStddev(h);
+
+	for(k = 0; k < 6; k++)
+		BENCH_FIELD(b, minField + k * sizeof(float)) = values[k];
+}
+
+/*
+ * Fonction collective de reunion sur le MASTER (dans all) des histogrammes h de tous les noeuds.
+ */
+void histoReduce(Histo* h, Histo* all) {
+	float bounds[2] = { h->min, -h->max }, allBounds[2];
+
+	/* Un histogramme vide ne doit pas peser sur le min et le max */
+	if(h->count == 0)
+		bounds[0] = bounds[1] = FLT_MAX;
+
+	MPI_Reduce(&h->sum, &all->sum, 2, MPI_DOUBLE, MPI_SUM, MASTER, MPI_COMM_WORLD);
+	MPI_Reduce(&h->count, &all->count, 1 + HISTO_BUCKETS, MPI_UNSIGNED, MPI_SUM, MASTER, MPI_COMM_WORLD);
+	MPI_Reduce(bounds, allBounds, 2, MPI_FLOAT, MPI_MIN, MASTER, MPI_COMM_WORLD);
+
+	all->min = (all->count > 0) ? allBounds[0] : 0;
+	all->max = (all->count > 0) ? -allBounds[1] : 0;
+}
+
+/*
+ * Ecriture en YAML du resume de la distribution d'une paire, sur une ligne (mapping YAML en ligne) : la mediane est le champ
+ * median, le reste suit minField (voir histoSummary).
+ */
+void distToYAML(FILE* yaml, char* name, Bench* b, size_t median, size_t minField) {
+	fprintf(
+		yaml,
+		"      %s : { min : %.3f, p50 : %.3f, p90 : %.3f, p99 : %.3f, p999 : %.3f, max : %.3f, stddev : %.3f, samples : %.0f }\n",
+		name,
+		BENCH_FIELD(b, minField),
+		BENCH_FIELD(b, median),
+		BENCH_FIELD(b, minField + sizeof(float)),
+		BENCH_FIELD(b, minField + 2 * sizeof(float)),
+		BENCH_FIELD(b, minField + 3 * sizeof(float)),
+		BENCH_FIELD(b, minField + 4 * sizeof(float)),
+		BENCH_FIELD(b, minField + 5 * sizeof(float)),
+		b->samples
+	);
 }
 
 /*
  * Liberation de la memoire pour les allocations faites manuellement.
  */
-void freee(int* buffer, MyResult* bissResults, YourTest* bissTests, MyResult** benchResults, Bench* sameBenchs, int nbNodes, int nbRetry) {
-	int i;
+void freee(int* buffer, Bench* bissResults, YourTest* bissTests, Results* results, Bench* sameBenchs) {
+	size_t i;
 
 	free(buffer);
 	free(bissResults);
 	free(bissTests);
 	free(sameBenchs);
 
-	for(i = 0; i < nbNodes; free(benchResults[i++]));
-	free(benchResults);
+	for(i = 0; i < BENCH_NB_FLOATS; free(results->fields[i++]));
 }
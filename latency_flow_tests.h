@@ -31,67 +31,544 @@
 #define SENDER 1
 #define MASTER 0
 
+/* Options qui attendent un argument (en plus de la chaine de getopt, pour les messages d'erreur et threadsRequested) */
+#define OPTIONS_WITH_ARG "sSpoBRTwWuaAfltmMDPxnkLIGKe"
+
+/* Horloges des mesures (option -k) : MPI_Wtime, clock_gettime(CLOCK_MONOTONIC_RAW) ou compteur TSC invariant du processeur */
+#define TIMER_WTIME 0
+#define TIMER_RAW 1
+#define TIMER_TSC 2
+
+/* Nombre de lectures consecutives de l'horloge pour mesurer son cout, et duree de l'etalonnage du TSC (en secondes) */
+#define TIMER_CALIBRATION_READS 1001
+#define TSC_CALIBRATION_TIME 0.05
+
+/* Delai des tests (option -e) : marge laissee a l'envoyeur pour renvoyer son resultat au MASTER (en secondes), et nombre
+d'etiquettes des messages des tests d'une meme paire, tirees a partir de TIMEOUT_TAG_BASE (voir testStart) */
+#define TIMEOUT_GRACE 1.0
+#define TIMEOUT_TAG_BASE 16
+#define TIMEOUT_TAGS 8192
+
+/* Horloge des mesures : duree d'un tic du TSC (en secondes), resolution annoncee et cout d'une lecture, qui est retranche de
+chaque duree mesuree (voir timerElapsed) */
+typedef struct {
+	int backend;
+	double tscPeriod, resolution, overhead;
+} Timer;
+
+/* Ranks et liens testes (option -t), et classes de liens des statistiques */
+#define TOPO_ALL 0
+#define TOPO_LEADERS 1
+#define TOPO_INTRA 2
+#define TOPO_INTER 3
+
+/* Bench, champs flottants et format du fichier binaire des resultats (option -B) */
+#include "results_file.h"
+
+/* Nombre d'aller-retours de chaque estimation du decalage des horloges (option -O), dont seul le plus court est garde */
+#define CLOCK_SYNC_ROUNDS 32
+
+/* Horloges des ranks, pour le MASTER dont l'horloge sert de reference : decalage au debut des tests (horloge du rank moins celle
+du MASTER) et son incertitude (moitie de l'aller-retour le plus court), date de cette estimation (en secondes depuis
+clockOrigin, sur l'horloge du MASTER), et derive (decalage gagne par seconde) mesuree par une seconde estimation a la fin */
 typedef struct {
-	int sender, recver;
-	float latency, flow;
-} Bench;
+	double *offset, *error, *at, *drift;
+} Clocks;
+
+/* Resultats de toutes les paires, pour le MASTER : une matrice nbNodes x nbNodes de flottants par champ des Bench (structure de
+tableaux), en y l'envoyeur et en x le receveur. Les champs inutiles aux options choisies ne sont pas alloues (NULL).
+En mode echantillonne (option -K), chaque envoyeur n'a que nbPartners receveurs (partners, nbNodes x nbPartners ranks, -1 pour
+les ranks non testes) : les matrices deviennent nbNodes x nbPartners, plus une derniere valeur a -1 pour tous les liens hors
+echantillon (voir resultIndex). nbPartners vaut 0 pour la matrice complete. */
+typedef struct {
+	int nbNodes, *nodeOf, nbPartners, *partners;
+	char* hostnames;
+	float* fields[BENCH_NB_FLOATS];
+	FILE* binFile; /* Fichier binaire ou chaque resultat est ajoute des son arrivee (option -B), sinon NULL */
+	Clocks* clocks; /* Horloges des ranks (option -O), sinon NULL */
+} Results;
+
+/* Valeur d'un champ des Bench (designe par son decalage) pour une paire */
+#define RESULT(r, field, sender, recver) ((r)->fields[BENCH_INDEX(field)][resultIndex(r, sender, recver)])
 
 typedef struct {
 	int role, withRank;
 } YourTest;
 
+/* Regroupement des ranks par machine : pour chaque rank, le leader (plus petit rank hors MASTER) de sa machine. Les ranks testes
+sont listes a la suite du MASTER. */
+typedef struct {
+	int *nodeOf, *players, nbPlayers, nbHosts;
+} Topology;
+
+/* Histogrammes logarithmiques : HISTO_SUB intervalles par octave, sur HISTO_OCTAVES octaves a partir de 2^HISTO_MIN_EXP (soit
+de 0.06 a 1 million d'unites, us ou Mo/s) */
+#define HISTO_SUB 16
+#define HISTO_OCTAVES 24
+#define HISTO_MIN_EXP -4
+#define HISTO_BUCKETS (HISTO_SUB * HISTO_OCTAVES)
+
 typedef struct {
-	char myHostname[100];
-	Bench result;
-} MyResult;
+	double sum, sumSq;
+	float min, max;
+	unsigned int count, buckets[HISTO_BUCKETS];
+} Histo;
 
 typedef struct {
-	Bench *min, *max;
+	Bench min, max;
 	float sum, avg;
+	int nb;
+	Histo histo;
 } StatsResult;
 
-MPI_Datatype BenchType, TestType, ResultType;
-MPI_Datatype benchTypeTypes[4] = { MPI_INT, MPI_INT, MPI_FLOAT, MPI_FLOAT };
+typedef struct {
+	float latencyMin, latencyAvg, latencyMax, flowMin, flowAvg, flowMax;
+} SweepPoint;
+
+typedef struct {
+	SweepPoint* points;
+	float nHalfMin, nHalfAvg, nHalfMax;
+	int nbLinks;
+} SweepStats;
+
+/* Inference de la topologie (option -I) : ecart relatif minimum entre deux hauteurs de fusion pour separer deux niveaux de
+groupes, et silhouette en dessous de laquelle une machine ne s'integre pas a son groupe */
+#define INFER_GAP 1.25
+#define INFER_MISFIT 0.1
+
+/* Lien entre deux machines (indices dans Infer.hosts) et sa distance, pour l'algorithme de Kruskal */
+typedef struct {
+	float d;
+	int a, b;
+} InferEdge;
+
+/* Arbre infere, pour le MASTER : machines (leurs leaders), distances entre elles (matrice nbHosts x nbHosts, -1 si aucun lien
+n'a ete teste), groupe de chaque machine a chaque niveau (represente par une de ses machines, niveau par niveau), seuils de
+distance des niveaux, silhouette de chaque machine dans son groupe du premier niveau et machines mal integrees */
+typedef struct {
+	int nbHosts, nbLevels, *hosts, *labels, *misfit;
+	float *d, *thresholds, *silhouette;
+	char* hostnames;
+} Infer;
+
+/* Placement des ranks (option -G) : schema de communication de l'application, et nombre maximum de passes de la recherche locale */
+#define PLACE_NONE 0
+#define PLACE_RING 1
+#define PLACE_STENCIL2D 2
+#define PLACE_STENCIL3D 3
+#define PLACE_GRAPH 4
+#define PLACE_PASSES 50
+
+/* Graphe de communication de l'application, par listes d'adjacence (les voisins du rank u sont adj[first[u]] a
+adj[first[u+1]-1], avec leurs poids) */
+typedef struct {
+	int nb, *first, *adj;
+	float* weight;
+} PlaceGraph;
+
+/* Mode echantillonne (option -K) : nombre de tours de la matrice concurrente par decalage (deux, ou trois si les cycles du
+decalage sont impairs) */
+#define SAMPLE_ROUNDS 3
+
+/* Estimation d'une machine en mode echantillonne : nombre de liens echantillonnes qui la touchent (envoyeur ou receveur), sommes
+et sommes des carres de leurs latences et debits */
+typedef struct {
+	int nb;
+	double latency, latencySq, flow, flowSq;
+} SampleHost;
+
+/* Ecart type de n valeurs a partir de leur somme et de la somme de leurs carres */
+#define SAMPLE_STDDEV(sum, sumSq, n) ((n) > 1 ? sqrt(fmax(0, ((sumSq) - (sum) * (sum) / (n)) / ((n) - 1))) : 0)
+
+/* Surveillance continue (option -m) : nombre de resultats gardes par lien, nombre minimum de resultats precedents pour servir de
+reference, et pas de l'attente des noeuds entre deux tours */
+#define MONITOR_RING 32
+#define MONITOR_MIN_BASELINE 3
+#define MONITOR_POLL_MS 10
+
+/* Derives signalees d'un lien */
+#define MONITOR_DRIFT_LATENCY 1
+#define MONITOR_DRIFT_FLOW 2
+
+/* Etat de la surveillance, pour le MASTER : pour chaque lien (envoyeur * nbNodes + receveur), un anneau de ses MONITOR_RING
+dernieres latences et derniers debits, le nombre de resultats recus, la reference (mediane des precedents) et la derive */
+typedef struct {
+	int nbNodes, period, *count, *drift;
+	char* hostnames;
+	float *latency, *flow, *latencyBase, *flowBase;
+} Monitor;
+
+/* Synchronisation des tests RMA (option -x), et operations testees */
+#define RMA_NONE 0
+#define RMA_FENCE 1
+#define RMA_PSCW 2
+#define RMA_LOCK 3
+#define RMA_PUT 0
+#define RMA_GET 1
+
+/* Paire d'un test RMA : communicateur et fenetre des deux seuls joueurs, rang du partenaire dans ce communicateur et son groupe */
+typedef struct {
+	MPI_Comm comm;
+	MPI_Win win;
+	MPI_Group peerGroup;
+	void* base;
+	int peer;
+} RmaPair;
+
+/* Latence sous charge (option -L) : roles des noeuds, et nombre de mesures de latence de chaque phase par repetition (-p) */
+#define LOADED_PROBE 1
+#define LOADED_BULK 2
+#define LOADED_PINGS 100
+
+/* Operations collectives testees (option -C) */
+#define COLL_BCAST 0
+#define COLL_REDUCE 1
+#define COLL_ALLREDUCE 2
+#define COLL_ALLGATHER 3
+#define COLL_ALLTOALL 4
+#define COLL_BARRIER 5
+#define COLL_NB_OPS 6
+
+/* Resume d'une operation collective pour une taille, a partir de la duree moyenne passee dedans par chaque rank et de ses dates
+d'entree : duree du plus lent (celle de l'operation), moyenne, decalage moyen des arrivees, rank le plus lent et rank arrive le
+dernier (en moyenne) */
+typedef struct {
+	float max, avg, skew;
+	int slowest, last;
+} CollStats;
+
+/* Politique des buffers (option -P), et taille d'une grande page */
+#define BUFFER_HUGE 1
+#define BUFFER_PREFAULT 2
+#define BUFFER_COLD 4
+#define BUFFER_THP 8
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+/* Taille de la zone parcourue en mode cold si le dernier niveau de cache est inconnu */
+#define COLD_DEFAULT_SIZE (64 * 1024 * 1024)
+
+typedef struct {
+	int
+		pktSize, /* Taille du mot qui sera envoye pour faire les tests de debit */
+		nbRetry, /* Nb de fois qu'un test sera recommence afin d'augmenter la precision */
+		bissection, /* Mode bissection ? */
+		randBiss, /* Mode bissection, avec formation des paires aleatoires ? */
+		yaml, /* Sortie dans un fichier YAML (yamlFile) en plus de la matrice ? */
+		bin, /* Sortie au fil des tests dans un fichier binaire (binFile) ? */
+		gnuplot, /* Sortie pour un graphique gnuplot plutot qu'une matrice ? */
+		concurrent, /* Mode matrice avec plusieurs paires testees en meme temps (tournoi round-robin) ? */
+		nbSizes, /* Nombre de tailles du balayage (option -S), 0 si il est desactive */
+		*sizes, /* Tailles du balayage, en octets et par ordre croissant */
+		*shifts, /* Decalages des partenaires du mode echantillonne, tires de seed (voir sampleInit) */
+		window, /* Nombre d'envois non bloquants en vol du test en flux continu (option -w), 0 si il est desactive */
+		nbWindows, /* Nombre de fenetres envoyees par le test en flux continu */
+		bidir, /* Test de debit bidirectionnel (option -d) ? */
+		topology, /* Ranks et liens testes (option -t) : TOPO_ALL, TOPO_LEADERS, TOPO_INTRA ou TOPO_INTER */
+		distributed, /* Matrice concurrente dont chaque noeud calcule lui meme ses tests (option -l) ? */
+		fan, /* Nombre maximum de noeuds face au premier du test incast/outcast (option -f), 0 si il est desactive */
+		warmup, /* Nombre de repetitions d'echauffement ignorees avant chaque test (option -u) */
+		maxRetry, /* Nombre maximum de repetitions d'un test en mode adaptatif (option -A) */
+		monitor, /* Periode en secondes de la surveillance continue (option -m), 0 si elle est desactivee */
+		monitorCount, /* Nombre de tours de la surveillance, 0 pour ne jamais s'arreter */
+		metrics, /* Ecriture des metriques de la surveillance dans metricsFile (option -M) ? */
+		bufferPolicy, /* Politique des buffers (option -P) : BUFFER_HUGE, BUFFER_PREFAULT et BUFFER_COLD, plus BUFFER_THP si les
+		grandes pages sont transparentes faute de pages hugetlbfs */
+		coldSize, /* Taille de la zone parcourue en mode cold, en octets */
+		integrity, /* Test d'integrite du contenu des mots (option -i) ? */
+		rma, /* Synchronisation des tests RMA (option -x) : RMA_FENCE, RMA_PSCW ou RMA_LOCK, RMA_NONE si ils sont desactives */
+		compare, /* Comparaison avec les resultats de reference de baselineFile (option -R) ? */
+		collectives, /* Test des operations collectives sur le balayage des tailles (option -C) ? */
+		threads, /* Nombre maximum de threads par rank du test multi threads (option -n), 0 si il est desactive */
+		oneWay, /* Latence dans chaque sens, apres estimation du decalage des horloges (option -O) ? */
+		timer, /* Horloge des mesures (option -k) : TIMER_WTIME, TIMER_RAW ou TIMER_TSC */
+		loaded, /* Nombre de paires sondes du test de latence sous charge (option -L), 0 si il est desactive */
+		sampled, /* Nombre de partenaires de chaque rank du mode echantillonne (option -K), 0 pour la matrice complete */
+		infer, /* Inference de la topologie a partir des resultats, ecrite dans inferFile (option -I) ? */
+		place; /* Schema de communication du placement des ranks (option -G) : PLACE_RING, PLACE_STENCIL2D, PLACE_STENCIL3D ou
+		PLACE_GRAPH (graphe de placeGraphFile), PLACE_NONE si il est desactive */
+	unsigned int
+		seed; /* Graine du melange des noeuds en mode distribue ou du tirage des partenaires en mode echantillonne, diffusee par
+		le MASTER */
+	float
+		threshold, /* Seuil de regression d'un lien par rapport a la reference, en pourcentage (option -T) */
+		drift, /* Seuil de derive d'un lien par rapport a sa reference en surveillance, en pourcentage (option -D) */
+		target, /* Precision visee sur les medianes en mode adaptatif, en pourcentage (option -a), 0 si il est desactive */
+		timeout; /* Duree maximum d'un test, toutes repetitions comprises, en secondes (option -e), 0 si elle est illimitee */
+	/* Noms des fichiers des options, qui pointent dans argv (sans limite de longueur) */
+	char
+		*yamlFile, /* Nom du fichier qui accueillera la sortie YAML si l'option -o est passee */
+		*binFile, /* Nom du fichier binaire des resultats si l'option -B est passee */
+		*metricsFile, /* Nom du fichier des metriques de la surveillance si l'option -M est passee */
+		*baselineFile, /* Nom du fichier binaire des resultats de reference si l'option -R est passee */
+		*inferFile, /* Nom du fichier de la topologie inferee (DOT si il finit par .dot, YAML sinon) si l'option -I est passee */
+		*placeGraphFile, /* Nom du fichier du graphe de communication pondere si l'option -G en donne un */
+		*rankFile; /* Nom du rankfile Open MPI du placement si l'option -G est passee */
+} Options;
+
+/* Flux d'un thread du test multi threads (option -n) : role et partenaire de la paire, communicateur propre au thread, mot
+envoye ou recu et duree des envois chronometres */
+typedef struct {
+	int role, peer;
+	MPI_Comm comm;
+	char* buf;
+	double time;
+	Options* o;
+} ThreadStream;
+
+MPI_Datatype BenchType, TestType;
+MPI_Datatype benchTypeTypes[2] = { MPI_INT, MPI_FLOAT };
 MPI_Datatype testTypeTypes[2] = { MPI_INT, MPI_INT };
-MPI_Aint benchTypeDisp[4], testTypeDisp[2], resultTypeDisp[2], extentType;
+MPI_Aint benchTypeDisp[2], testTypeDisp[2], extentType;
 MPI_Status status;
 
-int benchTypeBlocks[4] = { 1, 1, 1, 1 };
+int benchTypeBlocks[2] = { 2, BENCH_NB_FLOATS };
 int testTypeBlocks[2] = { 1, 1 };
-int resultTypeBlocks[2] = { 100, 1 };
 int* buffer;
 
-void initOptions(int argc, char** argv, int nbNodes, int rank, int* pktSize, int* nbRetry, int* bissection, int* randBiss, int* gnuplot, int* yaml, char* yamlFile);
+/* Reserve des buffers (voir bufferAlloc) : buffer pointe sur l'emplacement courant */
+char* bufferPool;
+size_t bufferSlotSize;
+int bufferNbSlots, bufferSlot;
+
+/* CRC32C du test d'integrite : table de la version logicielle, instruction SSE4.2 disponible ?, et numero du prochain motif */
+unsigned int crc32cTable[256];
+int crc32cHard = 0;
+unsigned long long integritySeq = 0;
+
+/* Horloge des mesures du noeud, et pour le MASTER la pire resolution et le pire cout de lecture de tous les noeuds */
+Timer timer, timerWorst;
+
+/* Decalage de l'horloge de chaque rank au debut des tests, connu de tous les noeuds (option -O), et origine des dates des tests
+sur l'horloge du MASTER */
+double* clockOffset;
+double clockOrigin;
+
+/* Test en cours avec un delai (option -e) : date limite sur MPI_Wtime (0 sans delai), etiquette des messages du ping-pong, et
+nombre de tests deja faits avec chaque rank (dont l'etiquette est tiree) */
+double testDeadline = 0;
+int testTag = 1;
+int* pairTests;
+
+/* Noms des operations collectives, dans l'ordre des COLL_* */
+char* collNames[COLL_NB_OPS] = { "Bcast", "Reduce", "Allreduce", "Allgather", "Alltoall", "Barrier" };
+
+void initOptions(int argc, char** argv, int nbNodes, int rank, Options* o);
+size_t bufferSize(Options* o);
+void bufferAlloc(Options* o);
+void bufferNext();
+void bufferPolicyName(char* str, Options* o);
+int coldDefaultSize();
+int parseSize(char* str);
+void timerInit(int rank, Options* o);
+double timerNow();
+double timerElapsed(double start, double stop);
+double timerCalibrate();
+double tscCalibrate();
+int tscInvariant();
+char* timerName(int backend);
+void timerDescribe(char* str);
+void formatSize(char* str, int size);
 
 void createBenchType();
 void createTestType();
-void createResultType();
 
-void prepareTests(int nbNodes, int sender);
+void prepareTests(Topology* topo, int i, Options* o);
 void launchTests(int sender, int recver);
 void waitTests(YourTest* t);
-void sendResults(MyResult* r);
-void receiveResults(MyResult* r, int sender);
+void prepareTest(int sender, int recver);
+void sendResults(Bench* r);
+int receiveResults(Bench* r, int sender, int recver, double deadline, Options* o);
+
+void formatTestsResult(Bench* r, YourTest* t, int rank);
+char* createHostnames(int nbNodes);
+
+void createTopology(Topology* t, int nbNodes, Options* o);
+int linkInClass(int* nodeOf, int sender, int recver, int linkClass);
+int linkSelected(Topology* t, int sender, int recver, Options* o);
+void topoMapTests(YourTest* bissTests, Topology* t, Options* o);
+int topoNbTests(Topology* t, int rank, Options* o);
+int topoNbRounds(Topology* t, Options* o);
+int topoNbRecvers(Topology* t, Options* o);
+int topoRecver(Topology* t, int i, int k, Options* o);
+void displayTopology(Topology* t);
+
+void initResults(Results* r, int nbNodes, char* hostnames, Topology* t, Options* o);
+FILE* createResultsFile(char* binFile, int nbNodes, char* hostnames, Options* o);
+int resultsFieldUsed(size_t field, Options* o);
+void storeResult(Results* r, Bench* b);
+void storeAllResults(Results* r, Bench* bissResults);
+void loadResult(Results* r, int sender, int recver, Bench* b);
+int resultTested(Results* r, int sender, int recver);
+int resultIndex(Results* r, int sender, int recver);
+int resultNbRecvers(Results* r);
+int resultRecver(Results* r, int sender, int k);
+int benchTests(YourTest* t, Bench* r, float* series, Options* o);
+int responsesToTests(YourTest* t, Options* o);
+void testStart(YourTest* t, Options* o);
+int timedWait(MPI_Request* req, double deadline);
+int timedSend(void* buf, int size, int peer);
+int timedRecv(void* buf, int size, int peer);
+int timeoutsSummary(Results* r, Options* o, int display);
+void timeoutsToYAML(FILE* f, Results* r);
+int moreTests(Bench* sameBenchs, int i, Options* o);
+int nextTest(YourTest* t, int i, int more, Options* o);
+int compareFloats(const void* a, const void* b);
+int benchsConverged(Bench* sameBenchs, int n, Options* o);
+float sortedMedian(float* values, int n);
+float benchsMedian(Bench* sameBenchs, int n, size_t field);
 
-void formatTestsResult(MyResult* r, YourTest* t, int rank);
-void benchTests(YourTest* t, Bench* r, int pktSize);
-void responsesToTests(YourTest* t, int pktSize);
+void streamTests(YourTest* t, Bench* r, Options* o);
+void responsesToStream(YourTest* t, Options* o);
+void bidirTests(YourTest* t, Bench* r, Options* o);
+void responsesToBidir(YourTest* t, Options* o);
+void rmaTests(YourTest* t, Bench* r, Options* o);
+void responsesToRma(YourTest* t, Options* o);
+void rmaOpen(YourTest* t, RmaPair* p, Options* o);
+void rmaClose(RmaPair* p);
+double rmaEpoch(RmaPair* p, int op, int size, int origin, Options* o);
+void rmaOp(RmaPair* p, int op, int size);
+char* rmaSyncName(Options* o);
+void oneWayTests(YourTest* t, Bench* r);
+void responsesToOneWay(YourTest* t);
+void clockSync(int rank, int nbNodes, double* offset, double* error, double* at);
+void clockStart(int rank, int nbNodes, Clocks* c);
+void clockEnd(int rank, int nbNodes, Clocks* c);
+void clockCorrect(Results* r, Clocks* c);
+void integrityTests(YourTest* t, Bench* r, Options* o);
+void responsesToIntegrity(YourTest* t, Options* o);
+void integrityFill(char* buf, int size, unsigned long long seed);
+void crc32cInit();
+unsigned int crc32c(const void* data, size_t len);
+unsigned int crc32cSSE42(const unsigned char* p, size_t len);
+void sweepTests(YourTest* t, float* series, Options* o);
+void responsesToSweep(YourTest* t, Options* o);
+
+int fanNbSteps(Options* o);
+int fanPeers(int step, Options* o);
+float* fanOf(float* flows, int step, int dir, Options* o);
+void fanAllTests(int rank, int nbNodes, char* hostnames, Options* o);
+void incastTests(float* times, int kept, Options* o);
+void responsesToIncast(int k, Options* o);
+void outcastTests(int k, float* times, int kept, Options* o);
+void responsesToOutcast(Options* o);
+float jainIndex(float* flows, int k);
+float fanAggregate(float* flows, int k);
+
+void collAllTests(int rank, int nbNodes, char* hostnames, Clocks* c, Options* o);
+void collDefaultSizes(Options* o);
+void collOp(int op, int size, char* sendBuf, char* recvBuf, MPI_Comm workers);
+void collStatsOf(float* times, double* entries, int op, int k, int nbNodes, CollStats* s, Options* o);
+
+int threadsRequested(int argc, char** argv);
+int threadsNbSteps(Options* o);
+int threadsOf(int step, Options* o);
+void threadsAllTests(int rank, int nbNodes, char* hostnames, Options* o);
+void* threadStream(void* arg);
+
+int loadedRole(int rank, int nbNodes, int* peer, int* role, Options* o);
+void loadedAllTests(int rank, int nbNodes, char* hostnames, Options* o);
+void loadedProbe(int peer, int role, Histo* h, Options* o);
+float loadedBulk(int peer, int role, MPI_Request* stop, Options* o);
+
+void monitorAllTests(int rank, int nbNodes, char* hostnames, Topology* topo, Options* o);
+void monitorInit(Monitor* m, int nbNodes, char* hostnames);
+void monitorFree(Monitor* m);
+void monitorTick(int period, double start, int rank, Options* o);
+void monitorStore(Monitor* m, Bench* b, Options* o);
+float monitorBaseline(float* ring, int count);
+void displayMonitor(Monitor* m, Bench* all);
+void monitorToFile(Monitor* m, Bench* all, Options* o);
+void monitorToPrometheus(FILE* f, Monitor* m);
+void monitorToJSONLine(FILE* f, Monitor* m, Bench* b);
 
 void bissPrepareAllTests(YourTest* bissTests, int nbNodes);
 void bissPrepareAllRandTests(YourTest* bissTests, int nbNodes);
 void bissTransmitAllTests(YourTest* bissTests, YourTest* t);
+
+int rrNbRounds(int nbNodes);
+void rrPrepareRoundTests(YourTest* bissTests, int nbNodes, int round);
+unsigned int distRand(unsigned int* state);
+void distPrepareRoundTests(YourTest* bissTests, int nbNodes, int round, unsigned int seed);
+void sampleInit(Topology* t, Options* o);
+int samplePartner(int i, int shift, int nbPlayers);
+void samplePrepareRoundTests(YourTest* bissTests, int nbPlayers, int round, Options* o);
+void displaySampleHosts(Results* r);
+void sampleHostsToYAML(FILE* yaml, Results* r);
+SampleHost* sampleHosts(Results* r);
+float confidence95(float stddev, int n);
+void distTransmitAllResults(Bench* myResults, float* mySweeps, int nb, Results* r, float* sweep, Options* o);
 void bissLaunchAllTests();
-void bissTransmitAllResults(MyResult* bissResults, MyResult* r);
+void bissTransmitAllResults(Bench* bissResults, Bench* r);
+void bissTransmitAllSweeps(float* bissSweeps, float* series, Options* o);
+void bissStoreAllSweeps(float* sweep, float* bissSweeps, Bench* rBiss, int nbNodes, Options* o);
 
-char* rankToHostname(MyResult** r, MyResult* rBiss, int rank, int bissection);
+void sendSweep(float* series, Options* o);
+void receiveSweep(float* series, int sender, Options* o);
+float* sweepOf(float* sweep, int sender, int recver, int nbNodes, Options* o);
+float sweepNHalf(float* series, Options* o);
 
-void displayTab(MyResult** r, MyResult* rBiss, int bissection, int nbNodes);
-void toYAML(MyResult** r, MyResult* rBiss, char* yamlFile, int nbNodes, int bissection);
+char* rankToHostname(char* hostnames, int rank);
+
+void displayTab(Results* r, Options* o);
+void displayTabLine(Results* r, int y, char* title, size_t field);
+void displayTabLatencyLine(Results* r, int y, char* title, size_t field);
+void displaySweep(Results* r, float* sweep, Options* o);
+void toYAML(Results* r, float* sweep, char* yamlFile, Options* o);
+void bidirToYAML(FILE* yaml, Bench* b);
+void integrityToYAML(FILE* yaml, Bench* b);
+void rmaToYAML(FILE* yaml, Bench* b);
+void oneWayToYAML(FILE* yaml, Bench* b);
+void displayClocks(Clocks* c, char* hostnames, int nbNodes);
+void clocksToYAML(FILE* yaml, Clocks* c, char* hostnames, int nbNodes);
+void sweepToYAML(FILE* yaml, float* series, Options* o);
+void displayFan(float* flows, char* hostname, Options* o);
+void fanToYAML(float* flows, char* hostname, char* yamlFile, Options* o);
+void displayThreads(float* flows, char* hostnames, int nbNodes, Options* o);
+void threadsToYAML(float* flows, char* hostnames, int nbNodes, char* yamlFile, Options* o);
+void displayLoaded(float* results, char* hostnames, int nbNodes, Options* o);
+void loadedToYAML(float* results, char* hostnames, int nbNodes, char* yamlFile, Options* o);
+void displayColl(float* times, double* entries, char* hostnames, int nbNodes, Options* o);
+void collToYAML(float* times, double* entries, char* hostnames, int nbNodes, char* yamlFile, Options* o);
+int compareResults(Results* r, ResultsFile* baseline, Options* o);
+int compareRank(Results* r, ResultsFile* baseline, int rank);
+int welchSignificant(float m1, float s1, float n1, float m2, float s2, float n2);
 void toGnuplot(StatsResult* flowStats, int nbNodes);
 
-void stats(MyResult** r, MyResult* rBiss, StatsResult* latencyStats, StatsResult* flowStats, int nbNodes, int bissection);
-void displayStats(MyResult** r, MyResult* rBiss, StatsResult* latencyStats, StatsResult* flowStats, int nbNodes, int bissection);
+void stats(Results* r, StatsResult* latencyStats, StatsResult* flowStats);
+void inferTopology(Results* r, char* inferFile, int display);
+void inferDistances(Results* r, Infer* in);
+int inferFind(int* parent, int i);
+int compareEdges(const void* a, const void* b);
+void inferLevels(Infer* in, InferEdge* edges, int nbEdges);
+void inferMisfits(Infer* in);
+void inferEmit(FILE* f, int dot, char* parent, int level, int* members, int nb, Infer* in);
+void displayInfer(Infer* in);
+int placeRanks(Results* r, Options* o, int display);
+int placeGraph(PlaceGraph* g, int nb, Options* o);
+void placeCosts(Results* r, int* slots, int nb, Options* o, float* c);
+float placeCost(PlaceGraph* g, float* c, int* map);
+void placeGreedy(PlaceGraph* g, float* c, int* map);
+int placeLocalSearch(PlaceGraph* g, float* c, int* map);
+float placeSwapDelta(PlaceGraph* g, float* c, int* map, int u, int v);
+void displayStats(Results* r, StatsResult* latencyStats, StatsResult* flowStats);
+void benchsSummary(Bench* sameBenchs, int nb, Bench* r, Histo* latencyHisto, Histo* flowHisto);
+void averageBenchs(Bench* sameBenchs, int nb, Bench* r);
+void fieldStats(Results* r, StatsResult* s, size_t field, int linkClass);
+void displayFieldStats(Results* r, StatsResult* s, size_t field, char* title, char* unit);
+void sweepStatsOf(float* sweep, SweepStats* s, int nbNodes, Options* o);
+void displaySweepStats(SweepStats* s, Options* o);
+
+void histoInit(Histo* h);
+int histoBucket(float value);
+void histoAdd(Histo* h, float value);
+void histoMerge(Histo* h, Histo* from);
+float histoPercentile(Histo* h, double p);
+float histoStddev(Histo* h);
+void displayHisto(Histo* h, char* unit);
+void histoSummary(Histo* h, Bench* b, size_t minField);
+void histoReduce(Histo* h, Histo* all);
+void distToYAML(FILE* yaml, char* name, Bench* b, size_t median, size_t minField);
 
-void freee(int* buffer, MyResult* bissResults, YourTest* bissTests, MyResult** benchResults, Bench* sameBenchs, int nbNodes, int nbRetry);
+void freee(int* buffer, Bench* bissResults, YourTest* bissTests, Results* results, Bench* sameBenchs);
 
 #endif
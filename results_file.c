@@ -0,0 +1,157 @@
+/*
+ * MPI LATENCY FLOW TESTS - FICHIER BINAIRE DES RESULTATS
+ *
+ * Ecriture au fil de l'eau et lecture par mmap du format binaire des resultats (voir results_file.h). Ce fichier ne depend pas
+ * de MPI, pour servir aussi a l'outil de conversion bwlat_convert.
+ *
+ * Copyright (C) 2010 Julien VAUBOURG / Sébastien BADIA
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "results_file.h"
+
+/* Noms des champs flottants d'un Bench, dans leur ordre dans la structure (noms des colonnes et des cles a l'export) */
+const char* benchFieldNames[] = {
+	"latency", "flow", "stream", "bidir_sum", "bidir_out", "bidir_in", "samples",
+	"latency_min", "latency_p90", "latency_p99", "latency_p999", "latency_max", "latency_stddev",
+	"flow_min", "flow_p90", "flow_p99", "flow_p999", "flow_max", "flow_stddev",
+	"verified_flow", "corrupted",
+	"put_latency", "put_flow", "get_latency", "get_flow",
+	"oneway_out", "oneway_in", "oneway_at",
+	"timed_out"
+};
+
+/*
+ * Creation du fichier binaire : l'entete (complete ici de la signature et des tailles) et la table des hostnames sont ecrits
+ * tout de suite, les enregistrements suivront avec resultsFileAppend. Renvoie NULL si le fichier ne peut etre ecrit.
+ */
+FILE* resultsFileCreate(char* path, ResultsFileHeader* h, char* hostnames) {
+	FILE* f = fopen(path, "wb");
+
+	if(f == NULL)
+		return NULL;
+
+	memcpy(h->magic, RESULTS_FILE_MAGIC, sizeof(h->magic));
+	h->version = RESULTS_FILE_VERSION;
+	h->hostnameSize = HOSTNAME_SIZE;
+	h->nbFields = BENCH_NB_FLOATS;
+	h->recordSize = sizeof(Bench);
+
+	fwrite(h, sizeof(ResultsFileHeader), 1, f);
+	fwrite(hostnames, HOSTNAME_SIZE, h->nbNodes, f);
+	fflush(f);
+
+	return f;
+}
+
+/*
+ * Ajout de l'enregistrement d'un lien en fin de fichier. Il est vide aussitot vers le disque : un test interrompu laisse un
+ * fichier lisible avec les liens deja testes.
+ */
+void resultsFileAppend(FILE* f, Bench* b) {
+	fwrite(b, sizeof(Bench), 1, f);
+	fflush(f);
+}
+
+/*
+ * Projection en memoire d'un fichier binaire, et verification de son entete. Renvoie 0 en cas d'erreur (message deja affiche).
+ */
+int resultsFileMap(char* path, ResultsFile* f) {
+	struct stat st;
+	size_t start;
+	int fd;
+
+	fd = open(path, O_RDONLY);
+
+	if(fd < 0 || fstat(fd, &st) < 0) {
+		fprintf(stderr, "ERROR: Can't read the results file %s.\n", path);
+		return 0;
+	}
+
+	f->size = st.st_size;
+
+	if(f->size < sizeof(ResultsFileHeader)) {
+		fprintf(stderr, "ERROR: %s is not a results file.\n", path);
+		close(fd);
+		return 0;
+	}
+
+	f->map = mmap(NULL, f->size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if(f->map == MAP_FAILED) {
+		fprintf(stderr, "ERROR: Can't map the results file %s.\n", path);
+		return 0;
+	}
+
+	f->header = (ResultsFileHeader*) f->map;
+	start = sizeof(ResultsFileHeader) + (size_t) f->header->nbNodes * f->header->hostnameSize;
+
+	if(memcmp(f->header->magic, RESULTS_FILE_MAGIC, sizeof(f->header->magic)) != 0 || f->size < start
+		|| f->header->recordSize != (int) (offsetof(Bench, latency) + f->header->nbFields * sizeof(float))) {
+		fprintf(stderr, "ERROR: %s is not a results file.\n", path);
+		resultsFileUnmap(f);
+		return 0;
+	}
+
+	if(f->header->version > RESULTS_FILE_VERSION) {
+		fprintf(stderr, "ERROR: %s has version %d, this program reads up to version %d.\n", path, f->header->version, RESULTS_FILE_VERSION);
+		resultsFileUnmap(f);
+		return 0;
+	}
+
+	f->hostnames = (char*) f->map + sizeof(ResultsFileHeader);
+	f->records = (char*) f->map + start;
+
+	/* Un dernier enregistrement incomplet (ecriture interrompue) est ignore */
+	f->nbRecords = (f->size - start) / f->header->recordSize;
+
+	return 1;
+}
+
+void resultsFileUnmap(ResultsFile* f) {
+	munmap(f->map, f->size);
+}
+
+/*
+ * Lecture du i-eme enregistrement. Les champs absents d'un fichier plus ancien (moins de champs) valent -1, comme des champs
+ * non mesures ; ceux d'un fichier plus recent, inconnus ici, sont ignores.
+ */
+void resultsFileGet(ResultsFile* f, int i, Bench* b) {
+	char* record = f->records + (size_t) i * f->header->recordSize;
+	size_t field, size = f->header->recordSize;
+
+	for(field = offsetof(Bench, latency); field < sizeof(Bench); field += sizeof(float))
+		BENCH_FIELD(b, field) = -1;
+
+	memcpy(b, record, size < sizeof(Bench) ? size : sizeof(Bench));
+}
+
+/*
+ * Nom du noeud d'un rank dans la table des hostnames du fichier.
+ */
+char* resultsFileHostname(ResultsFile* f, int rank) {
+	return f->hostnames + (size_t) rank * f->header->hostnameSize;
+}
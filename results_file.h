@@ -0,0 +1,96 @@
+/*
+ * MPI LATENCY FLOW TESTS - FICHIER BINAIRE DES RESULTATS
+ *
+ * Format binaire versionne des resultats, ecrit au fil des tests par le MASTER (option -B) et lisible par mmap (voir
+ * bwlat_convert). Le fichier se compose d'un entete de taille fixe, de la table des hostnames de tous les ranks, puis d'un
+ * enregistrement de taille fixe (un Bench) par lien teste, dans l'ordre d'arrivee des resultats. Les entiers et les flottants
+ * sont dans l'ordre des octets de la machine qui a ecrit le fichier.
+ *
+ * Copyright (C) 2010 Julien VAUBOURG / Sébastien BADIA
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef RESULTS_FILE
+#define RESULTS_FILE
+
+#include <stdio.h>
+#include <stddef.h>
+
+/* Acces a un champ flottant d'un Bench, a partir de son decalage dans la structure (offsetof) */
+#define BENCH_FIELD(b, field) (*(float*) ((char*) (b) + (field)))
+
+/* Resultat d'un test (ou d'une de ses repetitions). C'est aussi le seul type de resultat qui transite vers le MASTER : le resume
+des distributions (min, P90, P99, P99.9, max et ecart type) y remplace les histogrammes, qui restent sur l'envoyeur.
+C'est enfin l'enregistrement du fichier binaire : les nouveaux champs s'ajoutent toujours a la fin, pour que les anciens
+fichiers restent lisibles (voir resultsFileGet). */
+typedef struct {
+	int sender, recver;
+	float latency, flow, streamFlow, bidirFlow, bidirOut, bidirIn, samples,
+		latencyMin, latencyP90, latencyP99, latencyP999, latencyMax, latencyStddev,
+		flowMin, flowP90, flowP99, flowP999, flowMax, flowStddev,
+		verifiedFlow, corrupted,
+		putLatency, putFlow, getLatency, getFlow,
+		oneWayOut, oneWayIn, oneWayAt,
+		timedOut;
+} Bench;
+
+/* Nombre de champs flottants d'un Bench, qui se suivent tous a partir de la latence, et indice de l'un d'eux */
+#define BENCH_NB_FLOATS ((sizeof(Bench) - offsetof(Bench, latency)) / sizeof(float))
+#define BENCH_INDEX(field) (((field) - offsetof(Bench, latency)) / sizeof(float))
+
+/* Taille d'un nom de noeud dans la table des hostnames */
+#define HOSTNAME_SIZE 64
+
+/* Signature et version du format binaire */
+#define RESULTS_FILE_MAGIC "BWLATRES"
+#define RESULTS_FILE_VERSION 2
+
+/* Mode de test des resultats du fichier (champ flags de l'entete) */
+#define RESULTS_FILE_BISSECTION 1
+#define RESULTS_FILE_CONCURRENT 2
+#define RESULTS_FILE_DISTRIBUTED 4
+#define RESULTS_FILE_SAMPLED 8
+
+/* Entete du fichier binaire (64 octets). La table des hostnames (nbNodes x hostnameSize octets) le suit directement, puis les
+enregistrements de recordSize octets : deux entiers (envoyeur, receveur) et nbFields flottants. */
+typedef struct {
+	char magic[8];
+	int version, nbNodes, hostnameSize, nbFields, recordSize, flags, pktSize, nbRetry, window, nbWindows;
+	unsigned int seed;
+	int bufferPolicy, coldSize; /* Depuis la version 2 : politique des buffers (option -P) */
+	int rmaSync; /* Synchronisation des tests RMA (option -x), 0 sans test RMA */
+} ResultsFileHeader;
+
+/* Fichier binaire projete en memoire pour la lecture */
+typedef struct {
+	void* map;
+	size_t size;
+	ResultsFileHeader* header;
+	char* hostnames;
+	char* records;
+	int nbRecords;
+} ResultsFile;
+
+extern const char* benchFieldNames[];
+
+FILE* resultsFileCreate(char* path, ResultsFileHeader* h, char* hostnames);
+void resultsFileAppend(FILE* f, Bench* b);
+int resultsFileMap(char* path, ResultsFile* f);
+void resultsFileUnmap(ResultsFile* f);
+void resultsFileGet(ResultsFile* f, int i, Bench* b);
+char* resultsFileHostname(ResultsFile* f, int rank);
+
+#endif